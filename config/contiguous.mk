@@ -0,0 +1,5 @@
+include $(config_dir)base/base.mk
+include $(config_dir)base/dbg.mk
+
+# children of container elements are stored in std::vector, see SVGDOM_CONTIGUOUS_CHILDREN in src/svgdom/config.hpp
+this_cxxflags += -DSVGDOM_CONTIGUOUS_CHILDREN=1
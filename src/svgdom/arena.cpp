@@ -0,0 +1,64 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "arena.hxx"
+
+#include <utki/debug.hpp>
+
+using namespace svgdom;
+
+uint8_t* arena::add_block(size_t size){
+	this->blocks.push_back(std::unique_ptr<uint8_t[]>(new uint8_t[size]));
+	return this->blocks.back().get();
+}
+
+void* arena::allocate(size_t size, size_t alignment, size_t offset){
+	ASSERT(alignment <= heap_alignment)
+	ASSERT(offset < alignment)
+
+	if(this->cur){
+		auto misalignment = reinterpret_cast<uintptr_t>(this->cur) % alignment;
+		size_t padding = (offset + alignment - misalignment) % alignment;
+		if(padding <= this->left && size <= this->left - padding){
+			auto p = this->cur + padding;
+			this->cur = p + size;
+			this->left -= padding + size;
+			return p;
+		}
+	}
+
+	// start of the block is aligned to heap_alignment, so the offset is the only adjustment needed
+	if(size + offset > this->block_size / 2){
+		// big allocation goes to its own block, so that the rest of the current block is not wasted
+		return this->add_block(size + offset) + offset;
+	}
+
+	auto p = this->add_block(this->block_size) + offset;
+	this->cur = p + size;
+	this->left = this->block_size - offset - size;
+	return p;
+}
@@ -0,0 +1,83 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace svgdom{
+
+/**
+ * @brief Alignment of memory given by operator new(size_t).
+ * Elements allocated from arena are placed at half of this alignment, this way they can be told
+ * from the heap allocated elements by address.
+ */
+constexpr size_t heap_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+/**
+ * @brief Monotonic memory arena.
+ * Memory is handed out from big blocks. Individual allocations are never freed,
+ * all the blocks are freed at once when the arena is destroyed.
+ * The arena is not thread-safe, but different arenas can be used from different threads.
+ */
+class arena{
+	const size_t block_size;
+
+	std::vector<std::unique_ptr<uint8_t[]>> blocks;
+
+	uint8_t* cur = nullptr;
+	size_t left = 0;
+
+	uint8_t* add_block(size_t size);
+public:
+	constexpr static size_t default_block_size = 0x10000; // 64kb
+
+	arena(size_t block_size = default_block_size) :
+			block_size(block_size)
+	{}
+
+	arena(const arena&) = delete;
+	arena& operator=(const arena&) = delete;
+
+	/**
+	 * @brief Allocate memory from the arena.
+	 * @param size - number of bytes to allocate.
+	 * @param alignment - alignment of the memory, must not exceed heap_alignment.
+	 * @param offset - offset of the memory from the alignment boundary, must be less than alignment.
+	 * @return pointer p to the allocated memory, such that p % alignment == offset.
+	 */
+	void* allocate(size_t size, size_t alignment = heap_alignment, size_t offset = 0);
+
+	size_t num_blocks()const noexcept{
+		return this->blocks.size();
+	}
+};
+
+}
@@ -27,6 +27,27 @@ SOFTWARE.
 
 #pragma once
 
+/**
+ * @brief Contiguous storage of child elements.
+ * If defined to non-zero, the children of container elements are stored in std::vector instead of std::list,
+ * which makes traversing of wide element trees faster. See container::children_type for details.
+ * The library and its users must be compiled with the same value of this macro.
+ * The library and its tests are built with this storage by 'make config=contiguous test'.
+ */
+#ifndef SVGDOM_CONTIGUOUS_CHILDREN
+#	define SVGDOM_CONTIGUOUS_CHILDREN 0
+#endif
+
+/**
+ * @brief Loading statistics instrumentation.
+ * If defined to non-zero, the parser can gather statistics of loading SVG documents, see load_options::stats.
+ * When the statistics are not requested the instrumentation only costs a null pointer check per hook.
+ * If defined to 0, the instrumentation is compiled out completely and the statistics are never gathered.
+ */
+#ifndef SVGDOM_STATS
+#	define SVGDOM_STATS 1
+#endif
+
 namespace svgdom{
 
 typedef float real;
@@ -28,12 +28,26 @@ SOFTWARE.
 #include "dom.hpp"
 #include "config.hpp"
 
+#include <papki/fs_file.hpp>
+
 #include "parser.hxx"
+#include "mapped_file.hxx"
+#include "parallel.hxx"
 
 using namespace svgdom;
 
-std::unique_ptr<svg_element> svgdom::load(const papki::file& f){
-	svgdom::parser parser;
+std::unique_ptr<svg_element> svgdom::load(const papki::file& f, const load_options& options){
+	// regular files are memory mapped and given to the parser in one go
+	if(!f.is_open()){
+		if(auto fs_file = dynamic_cast<const papki::fs_file*>(&f)){
+			mapped_file mf(fs_file->path());
+			if(mf.is_mapped()){
+				return load(mf.span(), options);
+			}
+		}
+	}
+
+	svgdom::parser parser(options);
 	
 	{
 		papki::file::guard file_guard(f);
@@ -54,42 +68,69 @@ std::unique_ptr<svg_element> svgdom::load(const papki::file& f){
 	return parser.get_dom();
 }
 
-std::unique_ptr<svg_element> svgdom::load(std::istream& s){
-	svgdom::parser parser;
+std::unique_ptr<svg_element> svgdom::load(std::istream& s, const load_options& options){
+	svgdom::parser parser(options);
 	
-	static const size_t chunk_size = 0x1000; // 4kb
-
-	while(!s.eof()){
-		std::vector<char> buf;
-		buf.reserve(chunk_size);
-		for(size_t i = 0; i != chunk_size; ++i){
-			char c;
-			c = s.get();
-			if(s.eof()){
-				break;
-			}
-			buf.push_back(c);
+	std::vector<char> buf(0x10000); // 64kb
+
+	while(s.good()){
+		s.read(buf.data(), buf.size());
+		auto res = size_t(s.gcount());
+		ASSERT(res <= buf.size())
+		if(res == 0){
+			break;
 		}
-		parser.feed(utki::make_span(buf));
+		parser.feed(utki::make_span(buf.data(), res));
 	}
 	parser.end();
 	
 	return parser.get_dom();
 }
 
-std::unique_ptr<svg_element> svgdom::load(const std::string& s){
-	return load(utki::make_span(s));
+std::unique_ptr<svg_element> svgdom::load(const std::string& s, const load_options& options){
+	return load(utki::make_span(s), options);
 }
 
-std::unique_ptr<svg_element> svgdom::load(utki::span<const uint8_t> buf){
-	return load(utki::make_span(reinterpret_cast<const char*>(buf.data()), buf.size()));
+std::unique_ptr<svg_element> svgdom::load(utki::span<const uint8_t> buf, const load_options& options){
+	return load(utki::make_span(reinterpret_cast<const char*>(buf.data()), buf.size()), options);
 }
 
-std::unique_ptr<svg_element> svgdom::load(utki::span<const char> buf){
-	svgdom::parser parser;
+std::unique_ptr<svg_element> svgdom::load(utki::span<const char> buf, const load_options& options){
+	svgdom::parser parser(options);
 
 	parser.feed(buf);
 	parser.end();
 
 	return parser.get_dom();
-}
\ No newline at end of file
+}
+
+std::vector<load_result> svgdom::load_all(
+		utki::span<const utki::span<const char>> bufs,
+		unsigned num_threads,
+		const load_options& options
+	)
+{
+	std::vector<load_result> ret(bufs.size());
+
+	// each document is a separate task, loading errors are reported per document
+	run_tasks(
+			bufs.size(),
+			get_num_threads(num_threads),
+			[&](size_t i){
+				try{
+					if(options.stats){
+						// each document has its own statistics
+						auto doc_options = options;
+						doc_options.stats = &ret[i].stats;
+						ret[i].dom = load(bufs[i], doc_options);
+					}else{
+						ret[i].dom = load(bufs[i], options);
+					}
+				}catch(...){
+					ret[i].error = std::current_exception();
+				}
+			}
+		);
+
+	return ret;
+}
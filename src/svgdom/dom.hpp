@@ -27,6 +27,12 @@ SOFTWARE.
 
 #pragma once
 
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <exception>
+
 #include <utki/config.hpp>
 
 #include <papki/file.hpp>
@@ -35,42 +41,209 @@ SOFTWARE.
 
 namespace svgdom{
 
+/**
+ * @brief Statistics of loading SVG document.
+ * Gathered when requested with load_options::stats. If the library is built with SVGDOM_STATS defined to 0,
+ * the statistics are never gathered and all the values are zero after loading.
+ */
+struct load_stats{
+	/**
+	 * @brief Time spent in loading phases, in nanoseconds.
+	 */
+	struct phase_times{
+		/**
+		 * @brief Total time spent in the parser.
+		 * Reading the input, e.g. from file, is not included.
+		 */
+		uint64_t total = 0;
+
+		/**
+		 * @brief XML tokenization.
+		 * Everything not accounted to the other phases, i.e. total - elements - css.
+		 */
+		uint64_t xml = 0;
+
+		/**
+		 * @brief Creating elements and parsing their attributes.
+		 * Includes path_data and styles.
+		 */
+		uint64_t elements = 0;
+
+		/**
+		 * @brief Parsing path data of 'path' elements.
+		 */
+		uint64_t path_data = 0;
+
+		/**
+		 * @brief Parsing 'style' attributes and presentation attributes.
+		 */
+		uint64_t styles = 0;
+
+		/**
+		 * @brief Parsing CSS of 'style' elements.
+		 */
+		uint64_t css = 0;
+	} time;
+
+	/**
+	 * @brief Number of created elements per tag name.
+	 */
+	std::map<std::string, size_t, std::less<>> elements_per_tag;
+
+	/**
+	 * @brief Total number of created elements.
+	 */
+	size_t num_elements = 0;
+
+	/**
+	 * @brief Number of ignored elements.
+	 * Elements of unknown namespace or with unknown tag name.
+	 */
+	size_t num_unknown_elements = 0;
+
+	/**
+	 * @brief Number of bytes of 'path' elements' path data.
+	 * Counted also if parsing of the path data is deferred with load_options::lazy_parsing.
+	 */
+	size_t path_data_bytes = 0;
+
+	/**
+	 * @brief Number of parsed path steps.
+	 */
+	size_t num_path_steps = 0;
+
+	/**
+	 * @brief Number of parsed style properties.
+	 * Properties from 'style' attributes and presentation attributes. Properties whose parsing
+	 * is deferred with load_options::lazy_parsing are not counted.
+	 */
+	size_t num_style_properties = 0;
+
+	/**
+	 * @brief Number of memory allocations made for elements.
+	 * One per element. If load_options::use_arena is set, then one per arena block and one for the root element.
+	 */
+	size_t num_element_allocations = 0;
+};
+
+/**
+ * @brief SVG document loading options.
+ */
+struct load_options{
+	/**
+	 * @brief Allocate document elements from arena.
+	 * If true, element objects of the document, except the root element, are allocated from a monotonic
+	 * memory pool owned by the root element. Only the element objects themselves are allocated from the pool,
+	 * the memory owned by the elements, like lists of children, strings and style maps, is allocated and freed
+	 * as usual. Deleting an element which belongs to the pool only calls its destructor, the memory of the pool
+	 * is freed when the root element is deleted. So, the elements must not outlive the root element, e.g.
+	 * an element removed from the document tree must be deleted before the root element.
+	 */
+	bool use_arena = false;
+
+	/**
+	 * @brief Defer parsing of heavy attributes until first access.
+	 * If true, the text of 'd' attribute of 'path' elements, 'points' attribute of 'polyline' and 'polygon'
+	 * elements, 'style' attribute and presentation attributes of styleable elements is stored unparsed.
+	 * The text is kept in styleable::deferred and parsed into path_element::path, polyline_shape::points,
+	 * styleable::styles and styleable::presentation_attributes members by styleable::parse_deferred(),
+	 * until then those members are empty. Writers parse the text on their own without modifying the elements,
+	 * so the output is the same as for an eagerly loaded document.
+	 */
+	bool lazy_parsing = false;
+
+	/**
+	 * @brief Statistics of loading.
+	 * If not nullptr, the pointed structure is reset on every load and filled with statistics gathered
+	 * while loading the document.
+	 * Gathering the statistics adds some overhead, so it is not recommended to always have it on.
+	 */
+	load_stats* stats = nullptr;
+};
+
 /**
  * @brief Load SVG document.
  * Load SVG document from XML file.
+ * If the file is a papki::fs_file which refers to a regular file, then the file is memory mapped.
  * @param f - file interface to load SVG from.
+ * @param options - loading options.
  * @return unique pointer to the root of SVG document tree.
  */
-std::unique_ptr<svg_element> load(const papki::file& f);
+std::unique_ptr<svg_element> load(const papki::file& f, const load_options& options = load_options());
 
 /**
  * @brief Load SVG document.
  * Load SVG document from XML stream.
  * @param s - input stream to load SVG from.
+ * @param options - loading options.
  * @return unique pointer to the root of SVG document tree.
  */
-std::unique_ptr<svg_element> load(std::istream& s);
+std::unique_ptr<svg_element> load(std::istream& s, const load_options& options = load_options());
 
 /**
  * @brief Load SVG document.
  * Load SVG document from std::string.
  * @param s - input string to load SVG from.
+ * @param options - loading options.
  * @return unique pointer to the root of SVG document tree.
  */
-std::unique_ptr<svg_element> load(const std::string& s);
+std::unique_ptr<svg_element> load(const std::string& s, const load_options& options = load_options());
 
 /**
  * @brief Load SVG document from memory buffer.
  * @param buf - input buffer to load SVG from.
+ * @param options - loading options.
  * @return unique pointer to the root of SVG document tree.
  */
-std::unique_ptr<svg_element> load(utki::span<const char> buf);
+std::unique_ptr<svg_element> load(utki::span<const char> buf, const load_options& options = load_options());
 
 /**
  * @brief Load SVG document from memory buffer.
  * @param buf - input buffer to load SVG from.
+ * @param options - loading options.
  * @return unique pointer to the root of SVG document tree.
  */
-std::unique_ptr<svg_element> load(utki::span<const uint8_t> buf);
+std::unique_ptr<svg_element> load(utki::span<const uint8_t> buf, const load_options& options = load_options());
+
+/**
+ * @brief Result of loading one SVG document.
+ */
+struct load_result{
+	/**
+	 * @brief Root of the loaded SVG document tree.
+	 * nullptr if loading has failed.
+	 */
+	std::unique_ptr<svg_element> dom;
+
+	/**
+	 * @brief Exception thrown while loading the document.
+	 * Typically it is malformed_svg_error or std::invalid_argument.
+	 * nullptr if loading has succeeded.
+	 */
+	std::exception_ptr error;
+
+	/**
+	 * @brief Statistics of loading the document.
+	 * Only gathered if load_options::stats is not nullptr.
+	 */
+	load_stats stats;
+};
+
+/**
+ * @brief Load several SVG documents concurrently.
+ * Documents are distributed among the threads one by one as the threads become free.
+ * The calling thread is also used for loading.
+ * If options.stats is not nullptr, statistics of each document are stored to load_result::stats
+ * of the document, while the structure pointed by options.stats is not used.
+ * @param bufs - memory buffers to load SVG documents from.
+ * @param num_threads - maximum number of threads to use. 0 means number of hardware threads.
+ * @param options - loading options.
+ * @return loading results, in the same order as the input buffers.
+ */
+std::vector<load_result> load_all(
+		utki::span<const utki::span<const char>> bufs,
+		unsigned num_threads = 0,
+		const load_options& options = load_options()
+	);
 
 }
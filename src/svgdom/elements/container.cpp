@@ -0,0 +1,66 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "container.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace svgdom;
+
+void container::erase(utki::span<const children_type::iterator> iters){
+#if SVGDOM_CONTIGUOUS_CHILDREN
+	// erasing from vector invalidates the iterators following the erased one,
+	// so convert the iterators to indices and then compact the children in one pass,
+	// children which are nullptr but are not to be erased are kept
+	std::vector<size_t> indices;
+	indices.reserve(iters.size());
+	for(auto& i : iters){
+		indices.push_back(size_t(i - this->children.begin()));
+	}
+	if(indices.empty()){
+		return;
+	}
+	std::sort(indices.begin(), indices.end());
+
+	auto dst = this->children.begin() + indices.front();
+	auto next = indices.begin();
+	for(auto src = dst; src != this->children.end(); ++src){
+		if(next != indices.end() && size_t(src - this->children.begin()) == *next){
+			++next;
+			continue;
+		}
+		*dst = std::move(*src);
+		++dst;
+	}
+	this->children.erase(dst, this->children.end());
+#else
+	for(auto& i : iters){
+		this->children.erase(i);
+	}
+#endif
+}
@@ -27,9 +27,18 @@ SOFTWARE.
 
 #pragma once
 
-#include <list>
 #include <memory>
 
+#include <utki/span.hpp>
+
+#include "../config.hpp"
+
+#if SVGDOM_CONTIGUOUS_CHILDREN
+#	include <vector>
+#else
+#	include <list>
+#endif
+
 #include "element.hpp"
 
 namespace svgdom{
@@ -38,7 +47,20 @@ namespace svgdom{
  * @brief An element which can have child elements.
  */
 struct container{
-	std::list<std::unique_ptr<element>> children;
+	/**
+	 * @brief Storage type of child elements.
+	 * By default it is std::list. If SVGDOM_CONTIGUOUS_CHILDREN is non-zero, it is std::vector,
+	 * which is more cache friendly to traverse, but adding and erasing children invalidates
+	 * iterators to other children. To erase several children by stored iterators use erase(),
+	 * it works with both storage types.
+	 */
+#if SVGDOM_CONTIGUOUS_CHILDREN
+	typedef std::vector<std::unique_ptr<element>> children_type;
+#else
+	typedef std::list<std::unique_ptr<element>> children_type;
+#endif
+
+	children_type children;
 	
 	container() = default;
 	
@@ -49,6 +71,14 @@ struct container{
 	 * @param orig - object to copy.
 	 */
 	container(const container& orig){}
+
+	/**
+	 * @brief Erase several children.
+	 * Erases children pointed to by the given iterators. The iterators must be distinct and valid.
+	 * Order of the remaining children is preserved.
+	 * @param iters - iterators of the children to erase.
+	 */
+	void erase(utki::span<const children_type::iterator> iters);
 };
 
 }
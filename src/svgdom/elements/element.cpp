@@ -30,16 +30,46 @@ SOFTWARE.
 #include <ostream>
 #include <sstream>
 
+#include <utki/debug.hpp>
+
 #include "container.hpp"
+#include "../arena.hxx"
 #include "../visitor.hpp"
 #include "../util/stream_writer.hpp"
 
 using namespace svgdom;
 
+void* element::operator new(size_t size){
+	auto p = ::operator new(size);
+	ASSERT(reinterpret_cast<uintptr_t>(p) % heap_alignment == 0)
+	return p;
+}
+
+void* element::operator new(size_t size, svgdom::arena& a){
+	// unlike the heap allocated elements, the arena allocated ones are never aligned to heap_alignment
+	return a.allocate(size, heap_alignment, heap_alignment / 2);
+}
+
+void element::operator delete(void* p)noexcept{
+	if(reinterpret_cast<uintptr_t>(p) % heap_alignment != 0){
+		// allocated from arena, the memory is freed along with the arena
+		return;
+	}
+	::operator delete(p);
+}
+
+void element::operator delete(void* p, svgdom::arena& a)noexcept{
+	// the memory stays in the arena
+}
+
 std::string element::to_string()const{
+	return this->to_string(write_options());
+}
+
+std::string element::to_string(const write_options& options)const{
 	std::stringstream s;
 	
-	stream_writer visitor(s);
+	stream_writer visitor(s, options);
 	this->accept(visitor);
 	
 	return s.str();
@@ -33,6 +33,28 @@ namespace svgdom{
 
 class visitor;
 class const_visitor;
+class arena;
+struct container;
+struct styleable;
+
+/**
+ * @brief Options of writing the document as SVG text.
+ */
+struct write_options{
+	/**
+	 * @brief Write minified output.
+	 * If true, then no indentation and line breaks are written, path data is written
+	 * in the shortest form and presentation attributes which have their initial values are omitted.
+	 */
+	bool compact = false;
+
+	/**
+	 * @brief Number of significant digits to write numbers with.
+	 * Must be at least 1. Values greater than the number of digits needed to represent
+	 * the real type exactly give the same output as that number of digits.
+	 */
+	unsigned precision = 6;
+};
 
 /**
  * @brief Base class for all SVG document elements.
@@ -42,6 +64,13 @@ struct element{
 	
 	std::string to_string()const;
 
+	/**
+	 * @brief Write the element and its children as SVG text.
+	 * @param options - writing options.
+	 * @return SVG text of the element.
+	 */
+	std::string to_string(const write_options& options)const;
+
 	/**
 	 * @brief Accept method for visitor pattern.
 	 * @param v - visitor to accept.
@@ -60,7 +89,43 @@ struct element{
 	 */
 	virtual const std::string& get_tag()const = 0;
 
+	/**
+	 * @brief Get children container of the element.
+	 * Allows traversing the element tree without visitor, see traversal.hpp.
+	 * Custom elements which have children should override this method.
+	 * @return pointer to the container of the element's children.
+	 * @return nullptr if the element cannot have children.
+	 */
+	virtual const container* get_container()const noexcept{
+		return nullptr;
+	}
+
+	/**
+	 * @brief Get styleable part of the element.
+	 * @return pointer to the styleable part of the element.
+	 * @return nullptr if the element is not styleable.
+	 */
+	virtual const styleable* get_styleable()const noexcept{
+		return nullptr;
+	}
+
 	virtual ~element()noexcept{}
+
+	static void* operator new(size_t size);
+
+	/**
+	 * @brief Allocate element from arena.
+	 * Deleting the element allocated from the arena only calls its destructor,
+	 * the memory is freed when the arena is destroyed.
+	 * @param size - size of the element object.
+	 * @param a - arena to allocate the element from.
+	 */
+	static void* operator new(size_t size, svgdom::arena& a);
+
+	static void operator delete(void* p)noexcept;
+
+	// called only if element constructor throws
+	static void operator delete(void* p, svgdom::arena& a)noexcept;
 };
 
 }
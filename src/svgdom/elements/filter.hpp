@@ -58,6 +58,14 @@ struct filter_element :
 		return this->id;
 	}
 
+	const container* get_container()const noexcept override{
+		return this;
+	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
+
 	static const std::string tag;
 
 	const std::string& get_tag()const override{
@@ -75,6 +83,10 @@ struct filter_primitive :
 	const std::string& get_id()const override{
 		return this->id;
 	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
 };
 
 struct inputable{
@@ -70,6 +70,10 @@ struct gradient :
 			return this->id;
 		}
 
+		const styleable* get_styleable()const noexcept override{
+			return this;
+		}
+
 		static const std::string tag;
 
 		const std::string& get_tag()const override{
@@ -82,6 +86,14 @@ struct gradient :
 	const std::string& get_id()const override{
 		return this->id;
 	}
+
+	const container* get_container()const noexcept override{
+		return this;
+	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
 };
 
 struct linear_gradient_element : public gradient{
@@ -50,6 +50,10 @@ struct image_element :
 		return this->id;
 	}
 
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
+
 	static const std::string tag;
 
 	const std::string& get_tag()const override{
@@ -29,11 +29,15 @@ SOFTWARE.
 
 #include <sstream>
 #include <cctype>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
 
 #include <utki/debug.hpp>
 
 #include "../util.hxx"
 #include "../visitor.hpp"
+#include "../path_tokenizer.hxx"
 
 using namespace svgdom;
 
@@ -101,152 +105,396 @@ void polyline_element::accept(const_visitor& v) const {
 	v.visit(*this);
 }
 
-std::string polyline_shape::points_to_string() const {
-	std::stringstream s;
+decltype(polyline_shape::points) polyline_shape::parse_deferred_points()const{
+	if(!this->deferred || !this->points.empty()){
+		return this->points;
+	}
+	return parse(this->deferred->geometry);
+}
+
+void polyline_shape::parse_deferred(){
+	if(this->deferred && this->points.empty()){
+		this->points = parse(this->deferred->geometry);
+	}
+	this->styleable::parse_deferred();
+}
+
+std::string polyline_shape::points_to_string(unsigned precision)const{
+	std::string s;
 	
 	bool isFirst = true;
 	for(auto& p : this->points){
 		if(isFirst){
 			isFirst = false;
 		}else{
-			s << ',';
+			s += ',';
 		}
-		s << p[0] << ',' << p[1];
+		append_number(s, p[0], precision);
+		s += ',';
+		append_number(s, p[1], precision);
 	}
-	return s.str();
+	return s;
 }
 
-decltype(path_element::path) path_element::parse(std::string_view str){
-	decltype(path_element::path) ret;
+namespace{
+// reads number preceded by optional whitespaces and comma
+bool read_next_number(path_tokenizer& p, real& out){
+	p.skip_whitespaces_and_comma();
+	return p.read_number(out);
+}
+
+// reads arc flag preceded by optional whitespaces and comma
+bool read_next_flag(path_tokenizer& p, bool& out){
+	p.skip_whitespaces_and_comma();
+	return p.read_flag(out);
+}
+
+template <class on_step_type> void parse_path_data(std::string_view str, const on_step_type& on_step){
+	using step = path_element::step;
+
+	path_tokenizer p(str);
+	
+	p.skip_whitespaces();
 	
-	try{
-		utki::string_parser p(str);
+	step::type cur_step_type = step::type::unknown;
+	
+	while(!p.empty()){
+		ASSERT(!path_tokenizer::is_space(p.peek_char())) // spaces should be skept
+		
+		{
+			auto t = step::char_to_type(p.peek_char());
+			if(t != step::type::unknown){
+				cur_step_type = t;
+				p.skip_char();
+			}else if(cur_step_type == step::type::unknown){
+				cur_step_type = step::type::move_abs;
+			}else if(cur_step_type == step::type::move_abs){
+				cur_step_type = step::type::line_abs;
+			}else if(cur_step_type == step::type::move_rel){
+				cur_step_type = step::type::line_rel;
+			}
+		}
 		
 		p.skip_whitespaces();
 		
-		step::type cur_step_type = step::type::unknown;
+		step cur_step;
+		cur_step.type_ = cur_step_type;
 		
-		while(!p.empty()){
-			ASSERT(!utki::string_parser::is_space(p.peek_char())) // spaces should be skept
-			
-			{
-				auto t = step::char_to_type(p.peek_char());
-				if(t != step::type::unknown){
-					cur_step_type = t;
-					p.read_char();
-				}else if(cur_step_type == step::type::unknown){
-					cur_step_type = step::type::move_abs;
-				}else if(cur_step_type == step::type::move_abs){
-					cur_step_type = step::type::line_abs;
-				}else if(cur_step_type == step::type::move_rel){
-					cur_step_type = step::type::line_rel;
-				}
+		bool ok = true;
+
+		switch(cur_step.type_){
+			case step::type::move_abs:
+			case step::type::move_rel:
+			case step::type::line_abs:
+			case step::type::line_rel:
+				ok = p.read_number(cur_step.x)
+						&& read_next_number(p, cur_step.y);
+				break;
+			case step::type::close:
+				break;
+			case step::type::horizontal_line_abs:
+			case step::type::horizontal_line_rel:
+				ok = p.read_number(cur_step.x);
+				break;
+			case step::type::vertical_line_abs:
+			case step::type::vertical_line_rel:
+				ok = p.read_number(cur_step.y);
+				break;
+			case step::type::cubic_abs:
+			case step::type::cubic_rel:
+				ok = p.read_number(cur_step.x1)
+						&& read_next_number(p, cur_step.y1)
+						&& read_next_number(p, cur_step.x2)
+						&& read_next_number(p, cur_step.y2)
+						&& read_next_number(p, cur_step.x)
+						&& read_next_number(p, cur_step.y);
+				break;
+			case step::type::cubic_smooth_abs:
+			case step::type::cubic_smooth_rel:
+				ok = p.read_number(cur_step.x2)
+						&& read_next_number(p, cur_step.y2)
+						&& read_next_number(p, cur_step.x)
+						&& read_next_number(p, cur_step.y);
+				break;
+			case step::type::quadratic_abs:
+			case step::type::quadratic_rel:
+				ok = p.read_number(cur_step.x1)
+						&& read_next_number(p, cur_step.y1)
+						&& read_next_number(p, cur_step.x)
+						&& read_next_number(p, cur_step.y);
+				break;
+			case step::type::quadratic_smooth_abs:
+			case step::type::quadratic_smooth_rel:
+				ok = p.read_number(cur_step.x)
+						&& read_next_number(p, cur_step.y);
+				break;
+			case step::type::arc_abs:
+			case step::type::arc_rel:
+				ok = p.read_number(cur_step.rx)
+						&& read_next_number(p, cur_step.ry)
+						&& read_next_number(p, cur_step.x_axis_rotation)
+						&& read_next_flag(p, cur_step.flags.large_arc)
+						&& read_next_flag(p, cur_step.flags.sweep)
+						&& read_next_number(p, cur_step.x)
+						&& read_next_number(p, cur_step.y);
+				break;
+			default:
+				ASSERT(false)
+				break;
+		}
+
+		if(!ok){
+			LOG([&](auto& o){o << "WARNING: path_element::parse(): malformed path data, the rest of the path is ignored";})
+			break;
+		}
+		
+		on_step(cur_step);
+		
+		p.skip_whitespaces_and_comma();
+	}
+}
+}
+
+decltype(path_element::path) path_element::parse(std::string_view str){
+	decltype(path_element::path) ret;
+
+	parse_path_data(str, [&ret](const step& s){
+		ret.push_back(s);
+	});
+
+	return ret;
+}
+
+namespace{
+// command byte layout: lower bits hold the step type, upper bits hold the arc flags
+const uint8_t command_type_mask = 0x1f;
+const uint8_t command_large_arc_flag = 0x20;
+const uint8_t command_sweep_flag = 0x40;
+
+static_assert(unsigned(path_element::step::type::arc_rel) <= command_type_mask, "step type does not fit into command byte");
+
+unsigned num_coordinates(path_element::step::type t){
+	using step = path_element::step;
+
+	switch(t){
+		default:
+		case step::type::close:
+			return 0;
+		case step::type::horizontal_line_abs:
+		case step::type::horizontal_line_rel:
+		case step::type::vertical_line_abs:
+		case step::type::vertical_line_rel:
+			return 1;
+		case step::type::move_abs:
+		case step::type::move_rel:
+		case step::type::line_abs:
+		case step::type::line_rel:
+		case step::type::quadratic_smooth_abs:
+		case step::type::quadratic_smooth_rel:
+			return 2;
+		case step::type::cubic_smooth_abs:
+		case step::type::cubic_smooth_rel:
+		case step::type::quadratic_abs:
+		case step::type::quadratic_rel:
+			return 4;
+		case step::type::arc_abs:
+		case step::type::arc_rel:
+			return 5;
+		case step::type::cubic_abs:
+		case step::type::cubic_rel:
+			return 6;
+	}
+}
+}
+
+compact_path::compact_path(const decltype(path_element::path)& path){
+	this->commands.reserve(path.size());
+	for(const auto& s : path){
+		this->push_back(s);
+	}
+}
+
+compact_path::compact_path(std::vector<uint8_t> commands, std::vector<real> coordinates) :
+		commands(std::move(commands)),
+		coordinates(std::move(coordinates))
+{
+	size_t num_coords = 0;
+	for(auto c : this->commands){
+		unsigned t = c & command_type_mask;
+		if(t == unsigned(path_element::step::type::unknown) || t > unsigned(path_element::step::type::arc_rel)){
+			throw std::invalid_argument("compact_path::compact_path(): invalid command");
+		}
+		if((c & ~command_type_mask) != 0 && t != unsigned(path_element::step::type::arc_abs) && t != unsigned(path_element::step::type::arc_rel)){
+			throw std::invalid_argument("compact_path::compact_path(): arc flags set for non-arc command");
+		}
+		num_coords += num_coordinates(path_element::step::type(t));
+	}
+	if(num_coords != this->coordinates.size()){
+		throw std::invalid_argument("compact_path::compact_path(): number of coordinates does not match the commands");
+	}
+}
+
+compact_path compact_path::parse(std::string_view str){
+	compact_path ret;
+
+	parse_path_data(str, [&ret](const path_element::step& s){
+		ret.push_back(s);
+	});
+
+	return ret;
+}
+
+void compact_path::push_back(const path_element::step& s){
+	using step = path_element::step;
+
+	auto command = uint8_t(s.type_);
+	ASSERT((command & command_type_mask) == command)
+
+	switch(s.type_){
+		default:
+		case step::type::close:
+			break;
+		case step::type::horizontal_line_abs:
+		case step::type::horizontal_line_rel:
+			this->coordinates.push_back(s.x);
+			break;
+		case step::type::vertical_line_abs:
+		case step::type::vertical_line_rel:
+			this->coordinates.push_back(s.y);
+			break;
+		case step::type::move_abs:
+		case step::type::move_rel:
+		case step::type::line_abs:
+		case step::type::line_rel:
+		case step::type::quadratic_smooth_abs:
+		case step::type::quadratic_smooth_rel:
+			this->coordinates.insert(this->coordinates.end(), {s.x, s.y});
+			break;
+		case step::type::cubic_smooth_abs:
+		case step::type::cubic_smooth_rel:
+			this->coordinates.insert(this->coordinates.end(), {s.x2, s.y2, s.x, s.y});
+			break;
+		case step::type::quadratic_abs:
+		case step::type::quadratic_rel:
+			this->coordinates.insert(this->coordinates.end(), {s.x1, s.y1, s.x, s.y});
+			break;
+		case step::type::arc_abs:
+		case step::type::arc_rel:
+			this->coordinates.insert(this->coordinates.end(), {s.rx, s.ry, s.x_axis_rotation, s.x, s.y});
+			if(s.flags.large_arc){
+				command |= command_large_arc_flag;
 			}
-			
-			p.skip_whitespaces();
-			
-			step cur_step;
-			cur_step.type_ = cur_step_type;
-			
-			switch(cur_step.type_){
-				case step::type::move_abs:
-				case step::type::move_rel:
-				case step::type::line_abs:
-				case step::type::line_rel:
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::close:
-					break;
-				case step::type::horizontal_line_abs:
-				case step::type::horizontal_line_rel:
-					cur_step.x = p.read_number<real>();
-					break;
-				case step::type::vertical_line_abs:
-				case step::type::vertical_line_rel:
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::cubic_abs:
-				case step::type::cubic_rel:
-					cur_step.x1 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y1 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x2 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y2 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::cubic_smooth_abs:
-				case step::type::cubic_smooth_rel:
-					cur_step.x2 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y2 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::quadratic_abs:
-				case step::type::quadratic_rel:
-					cur_step.x1 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y1 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x = p.read_number<real>();					
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::quadratic_smooth_abs:
-				case step::type::quadratic_smooth_rel:
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::arc_abs:
-				case step::type::arc_rel:
-					cur_step.rx = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.ry = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x_axis_rotation = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.flags.large_arc = (p.read_char() != '0');
-					p.skip_whitespaces_and_comma();
-					cur_step.flags.sweep = (p.read_char() != '0');
-					p.skip_whitespaces_and_comma();
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				default:
-					ASSERT(false)
-					break;
+			if(s.flags.sweep){
+				command |= command_sweep_flag;
 			}
-			
-			ret.push_back(cur_step);
-			
-			p.skip_whitespaces_and_comma();
-		}
-	}catch(std::invalid_argument&
-#ifdef DEBUG
-			e
-#endif
-		)
-	{
-		LOG([&](auto& o){o << "WARNING: path_element::parse(): std::invalid_argument exception caught, ignored." << '\n' << "e.what() = " << e.what();})
-		// ignore
+			break;
+		case step::type::cubic_abs:
+		case step::type::cubic_rel:
+			this->coordinates.insert(this->coordinates.end(), {s.x1, s.y1, s.x2, s.y2, s.x, s.y});
+			break;
+	}
+
+	this->commands.push_back(command);
+}
+
+decltype(path_element::path) compact_path::to_steps()const{
+	decltype(path_element::path) ret;
+	ret.reserve(this->size());
+	for(const auto& s : *this){
+		ret.push_back(s);
 	}
-	
 	return ret;
 }
 
-std::string path_element::path_to_string() const {
-	std::stringstream s;
+path_element::step compact_path::const_iterator::operator*()const noexcept{
+	using step = path_element::step;
+
+	step ret{};
+	ret.type_ = step::type(*this->command & command_type_mask);
+
+	auto c = this->coordinate;
+
+	switch(ret.type_){
+		default:
+		case step::type::close:
+			break;
+		case step::type::horizontal_line_abs:
+		case step::type::horizontal_line_rel:
+			ret.x = c[0];
+			break;
+		case step::type::vertical_line_abs:
+		case step::type::vertical_line_rel:
+			ret.y = c[0];
+			break;
+		case step::type::move_abs:
+		case step::type::move_rel:
+		case step::type::line_abs:
+		case step::type::line_rel:
+		case step::type::quadratic_smooth_abs:
+		case step::type::quadratic_smooth_rel:
+			ret.x = c[0];
+			ret.y = c[1];
+			break;
+		case step::type::cubic_smooth_abs:
+		case step::type::cubic_smooth_rel:
+			ret.x2 = c[0];
+			ret.y2 = c[1];
+			ret.x = c[2];
+			ret.y = c[3];
+			break;
+		case step::type::quadratic_abs:
+		case step::type::quadratic_rel:
+			ret.x1 = c[0];
+			ret.y1 = c[1];
+			ret.x = c[2];
+			ret.y = c[3];
+			break;
+		case step::type::arc_abs:
+		case step::type::arc_rel:
+			ret.rx = c[0];
+			ret.ry = c[1];
+			ret.x_axis_rotation = c[2];
+			ret.x = c[3];
+			ret.y = c[4];
+			ret.flags.large_arc = (*this->command & command_large_arc_flag) != 0;
+			ret.flags.sweep = (*this->command & command_sweep_flag) != 0;
+			break;
+		case step::type::cubic_abs:
+		case step::type::cubic_rel:
+			ret.x1 = c[0];
+			ret.y1 = c[1];
+			ret.x2 = c[2];
+			ret.y2 = c[3];
+			ret.x = c[4];
+			ret.y = c[5];
+			break;
+	}
+
+	return ret;
+}
+
+compact_path::const_iterator& compact_path::const_iterator::operator++()noexcept{
+	this->coordinate += num_coordinates(path_element::step::type(*this->command & command_type_mask));
+	++this->command;
+	return *this;
+}
+
+decltype(path_element::path) path_element::parse_deferred_path()const{
+	if(!this->deferred || !this->path.empty()){
+		return this->path;
+	}
+	return parse(this->deferred->geometry);
+}
+
+void path_element::parse_deferred(){
+	if(this->deferred && this->path.empty()){
+		this->path = parse(this->deferred->geometry);
+	}
+	this->styleable::parse_deferred();
+}
+
+std::string path_element::path_to_string(unsigned precision)const{
+	std::string s;
 	
 	step::type cur_step_type = step::type::unknown;
 
@@ -254,15 +502,15 @@ std::string path_element::path_to_string() const {
 	
 	for(auto& cur_step : this->path){
 		if(cur_step_type == cur_step.type_){
-			s << " ";
+			s += ' ';
 		}else{
 			if (first) {
 				first = false;
 			} else {
-				s << " ";
+				s += ' ';
 			}
 			
-			s << step::type_to_char(cur_step.type_);
+			s += step::type_to_char(cur_step.type_);
 			cur_step_type = cur_step.type_;
 		}
 		
@@ -271,84 +519,349 @@ std::string path_element::path_to_string() const {
 			case step::type::move_rel:
 			case step::type::line_abs:
 			case step::type::line_rel:
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_number(s, cur_step.x, precision);
+				s += ',';
+				append_number(s, cur_step.y, precision);
 				break;
 			case step::type::close:
 				break;
 			case step::type::horizontal_line_abs:
 			case step::type::horizontal_line_rel:
-				s << cur_step.x;
+				append_number(s, cur_step.x, precision);
 				break;
 			case step::type::vertical_line_abs:
 			case step::type::vertical_line_rel:
-				s << cur_step.y;
+				append_number(s, cur_step.y, precision);
 				break;
 			case step::type::cubic_abs:
 			case step::type::cubic_rel:
-				s << cur_step.x1;
-				s << ",";
-				s << cur_step.y1;
-				s << " ";
-				s << cur_step.x2;
-				s << ",";
-				s << cur_step.y2;
-				s << " ";
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_number(s, cur_step.x1, precision);
+				s += ',';
+				append_number(s, cur_step.y1, precision);
+				s += ' ';
+				append_number(s, cur_step.x2, precision);
+				s += ',';
+				append_number(s, cur_step.y2, precision);
+				s += ' ';
+				append_number(s, cur_step.x, precision);
+				s += ',';
+				append_number(s, cur_step.y, precision);
 				break;
 			case step::type::cubic_smooth_abs:
 			case step::type::cubic_smooth_rel:
-				s << cur_step.x2;
-				s << ",";
-				s << cur_step.y2;
-				s << " ";
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_number(s, cur_step.x2, precision);
+				s += ',';
+				append_number(s, cur_step.y2, precision);
+				s += ' ';
+				append_number(s, cur_step.x, precision);
+				s += ',';
+				append_number(s, cur_step.y, precision);
 				break;
 			case step::type::quadratic_abs:
 			case step::type::quadratic_rel:
-				s << cur_step.x1;
-				s << ",";
-				s << cur_step.y1;
-				s << " ";
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_number(s, cur_step.x1, precision);
+				s += ',';
+				append_number(s, cur_step.y1, precision);
+				s += ' ';
+				append_number(s, cur_step.x, precision);
+				s += ',';
+				append_number(s, cur_step.y, precision);
 				break;
 			case step::type::quadratic_smooth_abs:
 			case step::type::quadratic_smooth_rel:
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_number(s, cur_step.x, precision);
+				s += ',';
+				append_number(s, cur_step.y, precision);
 				break;
 			case step::type::arc_abs:
 			case step::type::arc_rel:
-				s << cur_step.rx;
-				s << ",";
-				s << cur_step.ry;
-				s << " ";
-				s << cur_step.x_axis_rotation;
-				s << " ";
-				s << (cur_step.flags.large_arc ? "1" : "0");
-				s << ",";
-				s << (cur_step.flags.sweep ? "1" : "0");
-				s << " ";
-				s << cur_step.x;
-				s << ",";
-				s << cur_step.y;
+				append_number(s, cur_step.rx, precision);
+				s += ',';
+				append_number(s, cur_step.ry, precision);
+				s += ' ';
+				append_number(s, cur_step.x_axis_rotation, precision);
+				s += ' ';
+				s += cur_step.flags.large_arc ? '1' : '0';
+				s += ',';
+				s += cur_step.flags.sweep ? '1' : '0';
+				s += ' ';
+				append_number(s, cur_step.x, precision);
+				s += ',';
+				append_number(s, cur_step.y, precision);
 				break;
 			default:
 				ASSERT(false)
 				break;
 		}
 	}
-	return s.str();
+	return s;
 }
 
+namespace{
+// Writes path data segments in the shortest form.
+// Relative coordinates are calculated from the current point as the parser will see it
+// when reading the output back, this way rounding errors do not accumulate along the path.
+class compact_path_writer{
+	std::string& s;
+	const unsigned precision;
+
+	enum class token{
+		command,
+		integer,
+		fraction // number with decimal point, next number starting with '.' needs no separator
+	};
+
+	struct candidate{
+		std::string str;
+		std::array<real, 7> values; // numbers as they will be read back by the parser
+		token last_token;
+	};
+
+	// command which the parser assumes when numbers follow without command letter
+	char implicit_command = 0;
+
+	token last_token = token::command;
+
+	r4::vector2<real> cur{0, 0};
+	r4::vector2<real> subpath_start{0, 0};
+
+	// kept to reuse memory
+	candidate absolute;
+	candidate relative;
+	std::string number;
+
+	// formats the number into 'number' member, returns the value which the parser will read back
+	real format(real v, unsigned precision){
+		this->number.clear();
+		append_number(this->number, v, precision);
+		shorten_number(this->number, 0);
+
+		real ret;
+		path_tokenizer p(this->number);
+		if(!p.read_number(ret)){
+			ASSERT_INFO(false, "number = " << this->number)
+			ret = v;
+		}
+		return ret;
+	}
+
+	// decimal exponent of the first significant digit
+	static int exponent(real v){
+		using std::abs;
+		using std::floor;
+		using std::log10;
+		return int(floor(log10(abs(v))));
+	}
+
+	// Formats coordinate relative to the base with as few significant digits as possible,
+	// but so that the resulting absolute coordinate is as precise as if it was written in absolute form.
+	// Returns false if there is no such relative value.
+	bool format_relative(real target, real base, real& out){
+		using std::abs;
+
+		auto delta = target - base;
+		if(target == 0 || delta == 0){
+			out = this->format(delta, this->precision);
+			return base + out == target;
+		}
+
+		auto target_exponent = exponent(target);
+
+		// maximal rounding error of the target written in absolute form
+		using std::pow;
+		auto max_error = real(0.5) * pow(real(10), real(target_exponent - int(this->precision) + 1));
+
+		// Rounding error of the number with n significant digits is up to half of 10^(exponent - n + 1),
+		// so fewer digits than that give the target precision only if the dropped digits are zeros.
+		// Trailing zeros are not written anyway, so start right from that number of digits.
+		int min_digits = exponent(delta) - target_exponent + int(this->precision);
+
+		for(unsigned digits = unsigned(std::clamp(min_digits, 1, int(this->precision))); digits <= this->precision; ++digits){
+			out = this->format(delta, digits);
+			if(abs(base + out - target) <= max_error){
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Returns false if the relative candidate cannot represent the arguments precisely enough.
+	bool make_candidate(candidate& c, char command, std::string_view layout, const std::array<real, 7>& args, bool is_relative){
+		c.str.clear();
+		c.last_token = this->last_token;
+
+		if(command != this->implicit_command){
+			c.str += command;
+			c.last_token = token::command;
+		}
+
+		for(size_t i = 0; i != layout.size(); ++i){
+			if(is_relative && layout[i] != 'n'){
+				auto base = layout[i] == 'x' ? this->cur.x() : this->cur.y();
+				if(!this->format_relative(args[i], base, c.values[i])){
+					return false;
+				}
+			}else{
+				c.values[i] = this->format(args[i], this->precision);
+			}
+
+			char first = this->number.front();
+			if(
+					(c.last_token == token::integer && first != '-') ||
+					(c.last_token == token::fraction && first != '-' && first != '.')
+				)
+			{
+				c.str += ' ';
+			}
+			c.str += this->number;
+
+			c.last_token = this->number.find('.') == std::string::npos ? token::integer : token::fraction;
+		}
+		return true;
+	}
+public:
+	compact_path_writer(std::string& s, unsigned precision) :
+			s(s),
+			precision(std::max(precision, 1u)) // at least one digit, format_relative() relies on that
+	{}
+
+	/**
+	 * @param command - absolute command letter.
+	 * @param layout - one character per argument: 'x' and 'y' are coordinates, those are relative
+	 *                 to the current point in relative form, 'n' is any other number.
+	 * @param args - absolute form arguments.
+	 */
+	void write(char command, std::string_view layout, const std::array<real, 7>& args){
+		ASSERT(layout.size() <= args.size())
+
+		char rel_command = char(std::tolower(command));
+
+		this->make_candidate(this->absolute, command, layout, args, false);
+		bool is_relative = this->make_candidate(this->relative, rel_command, layout, args, true)
+				&& this->relative.str.size() < this->absolute.str.size();
+
+		const auto& c = is_relative ? this->relative : this->absolute;
+
+		this->s += c.str;
+		this->last_token = c.last_token;
+
+		auto base = is_relative ? this->cur : r4::vector2<real>{0, 0};
+		for(size_t i = 0; i != layout.size(); ++i){
+			switch(layout[i]){
+				case 'x':
+					this->cur.x() = base.x() + c.values[i];
+					break;
+				case 'y':
+					this->cur.y() = base.y() + c.values[i];
+					break;
+				default:
+					break;
+			}
+		}
+
+		if(command == 'M'){
+			this->subpath_start = this->cur;
+			// coordinate pairs following moveto are treated as lineto
+			this->implicit_command = is_relative ? 'l' : 'L';
+		}else{
+			this->implicit_command = is_relative ? rel_command : command;
+		}
+	}
+
+	void close(){
+		this->s += 'z';
+		this->last_token = token::command;
+		this->implicit_command = 0;
+		this->cur = this->subpath_start;
+	}
+};
+}
+
+std::string path_element::path_to_compact_string(unsigned precision)const{
+	std::string s;
+
+	compact_path_writer w(s, precision);
+
+	// current point and subpath start point as given by the path data
+	r4::vector2<real> cur{0, 0};
+	r4::vector2<real> subpath_start{0, 0};
+
+	for(auto& cur_step : this->path){
+		// relative steps have lower case letters
+		auto base = std::islower(step::type_to_char(cur_step.type_)) ? cur : r4::vector2<real>{0, 0};
+
+		real x = base.x() + cur_step.x;
+		real y = base.y() + cur_step.y;
+
+		switch(cur_step.type_){
+			case step::type::move_abs:
+			case step::type::move_rel:
+				w.write('M', "xy", {{x, y}});
+				subpath_start = r4::vector2<real>(x, y);
+				break;
+			case step::type::line_abs:
+			case step::type::line_rel:
+				w.write('L', "xy", {{x, y}});
+				break;
+			case step::type::close:
+				w.close();
+				x = subpath_start.x();
+				y = subpath_start.y();
+				break;
+			case step::type::horizontal_line_abs:
+			case step::type::horizontal_line_rel:
+				w.write('H', "x", {{x}});
+				y = cur.y();
+				break;
+			case step::type::vertical_line_abs:
+			case step::type::vertical_line_rel:
+				w.write('V', "y", {{y}});
+				x = cur.x();
+				break;
+			case step::type::cubic_abs:
+			case step::type::cubic_rel:
+				w.write('C', "xyxyxy", {{
+						base.x() + cur_step.x1,
+						base.y() + cur_step.y1,
+						base.x() + cur_step.x2,
+						base.y() + cur_step.y2,
+						x,
+						y
+					}});
+				break;
+			case step::type::cubic_smooth_abs:
+			case step::type::cubic_smooth_rel:
+				w.write('S', "xyxy", {{base.x() + cur_step.x2, base.y() + cur_step.y2, x, y}});
+				break;
+			case step::type::quadratic_abs:
+			case step::type::quadratic_rel:
+				w.write('Q', "xyxy", {{base.x() + cur_step.x1, base.y() + cur_step.y1, x, y}});
+				break;
+			case step::type::quadratic_smooth_abs:
+			case step::type::quadratic_smooth_rel:
+				w.write('T', "xy", {{x, y}});
+				break;
+			case step::type::arc_abs:
+			case step::type::arc_rel:
+				w.write('A', "nnnnnxy", {{
+						cur_step.rx,
+						cur_step.ry,
+						cur_step.x_axis_rotation,
+						cur_step.flags.large_arc ? real(1) : real(0),
+						cur_step.flags.sweep ? real(1) : real(0),
+						x,
+						y
+					}});
+				break;
+			default:
+				ASSERT(false)
+				break;
+		}
+
+		cur = r4::vector2<real>(x, y);
+	}
+	return s;
+}
 
 char path_element::step::type_to_char(step::type t){
 	switch(t){
@@ -445,30 +958,21 @@ path_element::step::type path_element::step::char_to_type(char c){
 decltype(polyline_shape::points) polyline_shape::parse(std::string_view s){
 	decltype(polyline_shape::points) ret;
 	
-	utki::string_parser p(s);
-
-	try{
-		while(!s.empty()){
-			decltype(ret)::value_type point;
+	path_tokenizer p(s);
 
-			point[0] = p.read_number<real>();
+	p.skip_whitespaces();
 
-			p.skip_whitespaces_and_comma();
+	while(!p.empty()){
+		decltype(ret)::value_type point;
 
-			point[1] = p.read_number<real>();
-			
-			ret.push_back(point);
-			
-			p.skip_whitespaces_and_comma();
+		if(!p.read_number(point[0]) || !read_next_number(p, point[1])){
+			LOG([&](auto& o){o << "WARNING: polyline_shape::parse(): malformed points, the rest of the points is ignored";})
+			break;
 		}
-	}catch(std::invalid_argument&
-#ifdef DEBUG
-			e
-#endif
-		)
-	{
-		LOG([&](auto& o){o << "WARNING: polyline_shape::parse(): std::invalid_argument exception caught, ignored." << '\n' << "e.what() = " << e.what();})
-		// ignore
+		
+		ret.push_back(point);
+		
+		p.skip_whitespaces_and_comma();
 	}
 	
 	return ret;
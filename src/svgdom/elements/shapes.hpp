@@ -32,6 +32,10 @@ SOFTWARE.
 #include "element.hpp"
 #include "rectangle.hpp"
 
+#include <iterator>
+
+#include <utki/span.hpp>
+
 #include <r4/vector.hpp>
 
 namespace svgdom{
@@ -47,6 +51,10 @@ struct shape :
 	const std::string& get_id()const override{
 		return this->id;
 	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
 };
 
 struct path_element : public shape{
@@ -108,9 +116,27 @@ struct path_element : public shape{
 
 	std::vector<step> path;
 	
-	std::string path_to_string()const;
+	std::string path_to_string(unsigned precision = 6)const;
+
+	/**
+	 * @brief Convert path data to the shortest text.
+	 * Each segment is written in absolute or relative form, whichever is shorter.
+	 * Repeated command letters, unnecessary separators and leading zeros are omitted.
+	 * @param precision - number of significant digits of coordinates, 0 is treated as 1.
+	 * @return path data text.
+	 */
+	std::string path_to_compact_string(unsigned precision = 6)const;
 	
 	static decltype(path) parse(std::string_view str);
+
+	/**
+	 * @brief Get 'path' with the deferred path data text parsed.
+	 * Does not modify the element. If 'path' is not empty, the deferred text is ignored.
+	 * @return path steps as they will be after parse_deferred().
+	 */
+	decltype(path) parse_deferred_path()const;
+
+	void parse_deferred()override;
 	
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
@@ -122,6 +148,139 @@ struct path_element : public shape{
 	}
 };
 
+/**
+ * @brief Compact storage of path steps.
+ * Instead of storing a full path_element::step for every path step, the path is stored
+ * as an array of one byte commands and a packed stream of coordinates. Each command only takes
+ * as many coordinates from the stream as its step type actually uses, e.g. 'close' step takes none,
+ * 'horizontal line' step takes one. Arc flags are packed into the command byte.
+ * This is useful for keeping a lot of paths in memory.
+ */
+class compact_path{
+	std::vector<uint8_t> commands;
+	std::vector<real> coordinates;
+public:
+	compact_path() = default;
+
+	explicit compact_path(const decltype(path_element::path)& path);
+
+	/**
+	 * @brief Construct from packed representation.
+	 * @param commands - command bytes, as returned by get_commands().
+	 * @param coordinates - coordinates stream, as returned by get_coordinates().
+	 * @throw std::invalid_argument - if there is invalid or unknown command, or number of coordinates does not match the commands.
+	 */
+	compact_path(std::vector<uint8_t> commands, std::vector<real> coordinates);
+
+	/**
+	 * @brief Parse path data.
+	 * Same as path_element::parse(), but produces compact path.
+	 * @param str - path data string.
+	 * @return parsed compact path.
+	 */
+	static compact_path parse(std::string_view str);
+
+	/**
+	 * @brief Append step to the path.
+	 * @param s - step to append.
+	 */
+	void push_back(const path_element::step& s);
+
+	/**
+	 * @brief Get number of steps in the path.
+	 * @return number of steps.
+	 */
+	size_t size()const noexcept{
+		return this->commands.size();
+	}
+
+	bool empty()const noexcept{
+		return this->commands.empty();
+	}
+
+	void clear()noexcept{
+		this->commands.clear();
+		this->coordinates.clear();
+	}
+
+	void shrink_to_fit(){
+		this->commands.shrink_to_fit();
+		this->coordinates.shrink_to_fit();
+	}
+
+	/**
+	 * @brief Convert to full steps.
+	 * @return vector of steps.
+	 */
+	decltype(path_element::path) to_steps()const;
+
+	/**
+	 * @brief Get command bytes.
+	 * Each command byte holds the step type and, for arc steps, the arc flags.
+	 * @return command bytes.
+	 */
+	utki::span<const uint8_t> get_commands()const noexcept{
+		return utki::make_span(this->commands);
+	}
+
+	/**
+	 * @brief Get packed coordinates.
+	 * @return coordinates stream.
+	 */
+	utki::span<const real> get_coordinates()const noexcept{
+		return utki::make_span(this->coordinates);
+	}
+
+	/**
+	 * @brief Iterator over path steps.
+	 * The iterator yields path_element::step objects by value, the steps are unpacked on the fly.
+	 * Fields of the step which are not used by the step type are set to zero.
+	 */
+	class const_iterator{
+		friend class compact_path;
+
+		const uint8_t* command;
+		const real* coordinate;
+
+		const_iterator(const uint8_t* command, const real* coordinate) :
+				command(command),
+				coordinate(coordinate)
+		{}
+	public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef path_element::step value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const path_element::step* pointer;
+		typedef path_element::step reference;
+
+		path_element::step operator*()const noexcept;
+
+		const_iterator& operator++()noexcept;
+
+		const_iterator operator++(int)noexcept{
+			auto ret = *this;
+			++(*this);
+			return ret;
+		}
+
+		bool operator==(const const_iterator& i)const noexcept{
+			return this->command == i.command;
+		}
+
+		bool operator!=(const const_iterator& i)const noexcept{
+			return !this->operator==(i);
+		}
+	};
+
+	const_iterator begin()const noexcept{
+		return const_iterator(this->commands.data(), this->coordinates.data());
+	}
+
+	const_iterator end()const noexcept{
+		return const_iterator(this->commands.data() + this->commands.size(), this->coordinates.data() + this->coordinates.size());
+	}
+};
+
 struct rect_element :
 		public shape,
 		public rectangle
@@ -198,9 +357,18 @@ struct line_element : public shape{
 struct polyline_shape : public shape{
 	std::vector<r4::vector2<real>> points;
 	
-	std::string points_to_string()const;
+	std::string points_to_string(unsigned precision = 6)const;
 
 	static decltype(points) parse(std::string_view s);
+
+	/**
+	 * @brief Get 'points' with the deferred points text parsed.
+	 * Does not modify the element. If 'points' is not empty, the deferred text is ignored.
+	 * @return points as they will be after parse_deferred().
+	 */
+	decltype(points) parse_deferred_points()const;
+
+	void parse_deferred()override;
 };
 
 struct polyline_element : public polyline_shape{
@@ -27,6 +27,8 @@ SOFTWARE.
 
 #pragma once
 
+#include <memory>
+
 #include "container.hpp"
 #include "transformable.hpp"
 #include "styleable.hpp"
@@ -51,6 +53,14 @@ struct g_element :
 		return this->id;
 	}
 
+	const container* get_container()const noexcept override{
+		return this;
+	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
+
 	static const std::string tag;
 
 	const std::string& get_tag()const override{
@@ -71,6 +81,14 @@ struct defs_element :
 		return this->id;
 	}
 
+	const container* get_container()const noexcept override{
+		return this;
+	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
+
 	static const std::string tag;
 
 	const std::string& get_tag()const override{
@@ -92,6 +110,10 @@ struct use_element :
 		return this->id;
 	}
 
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
+
 	static const std::string tag;
 
 	const std::string& get_tag()const override{
@@ -107,6 +129,18 @@ struct svg_element :
 		public aspect_ratioed,
 		public styleable
 {
+private:
+	friend class parser;
+
+	// arena the descendant elements are allocated from, if the document was loaded with load_options::use_arena
+	std::shared_ptr<svgdom::arena> element_arena;
+
+public:
+	~svg_element()noexcept{
+		// the children can be allocated from the arena, so they are destroyed before it
+		this->children.clear();
+	}
+
 	void accept(visitor& v)override;
 	void accept(const_visitor& v) const override;
 
@@ -114,6 +148,14 @@ struct svg_element :
 		return this->id;
 	}
 
+	const container* get_container()const noexcept override{
+		return this;
+	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
+
 	static const std::string tag;
 
 	const std::string& get_tag()const override{
@@ -152,6 +194,14 @@ struct symbol_element :
 		return this->id;
 	}
 
+	const container* get_container()const noexcept override{
+		return this;
+	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
+
 	static const std::string tag;
 
 	const std::string& get_tag()const override{
@@ -176,6 +226,14 @@ struct mask_element :
 		return this->id;
 	}
 
+	const container* get_container()const noexcept override{
+		return this;
+	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
+
 	static const std::string tag;
 
 	const std::string& get_tag()const override{
@@ -27,6 +27,11 @@ SOFTWARE.
 
 #include "style.hpp"
 
+#include <utki/string.hpp>
+
+#include <papki/span_file.hpp>
+#include <papki/vector_file.hpp>
+
 #include "../visitor.hpp"
 
 using namespace svgdom;
@@ -40,3 +45,40 @@ void style_element::accept(visitor& v){
 void style_element::accept(const_visitor& v)const{
 	v.visit(*this);
 }
+
+std::string style_element::css_to_string(const std::string& indent)const{
+	papki::vector_file fi;
+	this->css.write(
+			fi,
+			[](uint32_t id) -> std::string{
+				return std::string(styleable::property_to_string(style_property(id)));
+			},
+			[](uint32_t id, const cssom::property_value_base& value) -> std::string{
+				return styleable::style_value_to_string(
+						style_property(id),
+						static_cast<const css_style_value&>(value).value
+					);
+			},
+			indent
+		);
+
+	return utki::make_string(fi.reset_data());
+}
+
+cssom::sheet style_element::parse_css(std::string_view str){
+	return cssom::read(
+			papki::span_file(utki::make_span(str.data(), str.size())),
+			[](const std::string& name) -> uint32_t{
+				return uint32_t(styleable::string_to_property(name));
+			},
+			[](uint32_t id, std::string&& v) -> std::unique_ptr<cssom::property_value_base>{
+				auto sp = style_property(id);
+				if(sp == style_property::unknown){
+					return nullptr;
+				}
+				auto ret = std::make_unique<css_style_value>();
+				ret->value = styleable::parse_style_property_value(sp, v);
+				return ret;
+			}
+		);
+}
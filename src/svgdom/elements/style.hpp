@@ -33,6 +33,7 @@ SOFTWARE.
 #include <cssom/om.hpp>
 
 #include <string>
+#include <string_view>
 
 namespace svgdom{
 
@@ -45,6 +46,20 @@ struct style_element : public element{
 
 	static const std::string tag;
 
+	/**
+	 * @brief Convert CSS to string.
+	 * @param indent - indentation to add to each line.
+	 * @return CSS text.
+	 */
+	std::string css_to_string(const std::string& indent = std::string())const;
+
+	/**
+	 * @brief Parse CSS.
+	 * @param str - CSS text.
+	 * @return CSS sheet with property values of type css_style_value.
+	 */
+	static cssom::sheet parse_css(std::string_view str);
+
 	const std::string& get_tag()const override{
 		return tag;
 	}
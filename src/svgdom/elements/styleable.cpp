@@ -43,13 +43,13 @@ SOFTWARE.
 using namespace svgdom;
 
 namespace{
-const char* none_word = "none";
-const char* inherit_word = "inherit";
-const char* current_color_word = "currentColor";
+const char* const none_word = "none";
+const char* const inherit_word = "inherit";
+const char* const current_color_word = "currentColor";
 }
 
 namespace{
-std::string stroke_dasharray_to_string(const style_value& v){
+std::string stroke_dasharray_to_string(const style_value& v, unsigned precision){
 	// special values must be already handled by styleable::style_value_to_string() at this point
 	ASSERT_INFO(!std::holds_alternative<style_value_special>(v), "v = " << unsigned(*std::get_if<style_value_special>(&v)))
 
@@ -57,18 +57,18 @@ std::string stroke_dasharray_to_string(const style_value& v){
 		return std::string();
 	}
 
-	std::stringstream ss;
+	std::string ret;
 
 	auto dasharray = *std::get_if<std::vector<length>>(&v);
 
 	for(auto i = dasharray.begin(); i != dasharray.end(); ++i){
 		if(i != dasharray.begin()){
-			ss << " ";
+			ret += ' ';
 		}
-		ss << (*i);
+		append_length(ret, *i, precision);
 	}
 
-	return ss.str();
+	return ret;
 }
 }
 
@@ -97,7 +97,7 @@ style_value parse_stroke_dasharray(std::string_view str){
 }
 }
 
-std::string styleable::style_value_to_string(style_property p, const style_value& v){
+std::string styleable::style_value_to_string(style_property p, const style_value& v, unsigned precision){
 	if(!is_valid(v)){
 		return std::string();
 	}
@@ -110,13 +110,13 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 		return current_color_word;
 	}
 
-	std::stringstream s;
+	std::string s;
 	switch(p){
 		default:
 			TRACE(<< "Unimplemented style property: " << styleable::property_to_string(p) << ", writing empty value." << std::endl)
 			break;
 		case style_property::color_interpolation_filters:
-			s << color_interpolation_filters_to_string(v);
+			s += color_interpolation_filters_to_string(v);
 			break;
 		case style_property::stroke_miterlimit:
 		case style_property::stop_opacity:
@@ -124,18 +124,18 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 		case style_property::stroke_opacity:
 		case style_property::fill_opacity:
 			if(std::holds_alternative<real>(v)){
-				s << *std::get_if<real>(&v);
+				append_number(s, *std::get_if<real>(&v), precision);
 			}
 			break;
 		case style_property::stop_color:
 		case style_property::fill:
 		case style_property::stroke:
-			s << paint_to_string(v);
+			s += paint_to_string(v);
 			break;
 		case style_property::stroke_dashoffset:
 		case style_property::stroke_width:
 			if(std::holds_alternative<length>(v)){
-				s << *std::get_if<length>(&v);
+				append_length(s, *std::get_if<length>(&v), precision);
 			}
 			break;
 		case style_property::stroke_linecap:
@@ -145,13 +145,13 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 						ASSERT(false)
 						break;
 					case stroke_line_cap::butt:
-						s << "butt";
+						s += "butt";
 						break;
 					case stroke_line_cap::round:
-						s << "round";
+						s += "round";
 						break;
 					case stroke_line_cap::square:
-						s << "square";
+						s += "square";
 						break;
 				}
 			}
@@ -163,13 +163,13 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 						ASSERT(false)
 						break;
 					case stroke_line_join::miter:
-						s << "miter";
+						s += "miter";
 						break;
 					case stroke_line_join::round:
-						s << "round";
+						s += "round";
 						break;
 					case stroke_line_join::bevel:
-						s << "bevel";
+						s += "bevel";
 						break;
 				}
 			}
@@ -181,10 +181,10 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 						ASSERT(false)
 						break;
 					case fill_rule::evenodd:
-						s << "evenodd";
+						s += "evenodd";
 						break;
 					case fill_rule::nonzero:
-						s << "nonzero";
+						s += "nonzero";
 						break;
 				}
 			}
@@ -192,57 +192,64 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 		case style_property::mask:
 		case style_property::filter:
 			if(std::holds_alternative<std::string>(v)){
-				s << "url(" << *std::get_if<std::string>(&v) << ")";
+				s += "url(";
+				s += *std::get_if<std::string>(&v);
+				s += ')';
 			}
 			break;
 		case style_property::display:
-			s << display_to_string(v);
+			s += display_to_string(v);
 			break;
 		case style_property::enable_background:
-			s << enable_background_to_string(v);
+			s += enable_background_to_string(v, precision);
 			break;
 		case style_property::visibility:
-			s << visibility_to_string(v);
+			s += visibility_to_string(v);
 			break;
 		case style_property::stroke_dasharray:
-			s << stroke_dasharray_to_string(v);
+			s += stroke_dasharray_to_string(v, precision);
 			break;
 	}
-	return s.str();
+	return s;
+}
+
+std::string styleable::styles_to_string(unsigned precision)const{
+	return styles_to_string(this->styles, precision);
 }
 
-std::string styleable::styles_to_string()const{
-	std::stringstream s;
+std::string styleable::styles_to_string(const style_map& styles, unsigned precision){
+	std::string s;
 	
 	bool isFirst = true;
 	
-	for(auto& st : this->styles){
+	for(auto& st : styles){
 		if(isFirst){
 			isFirst = false;
 		}else{
-			s << "; ";
+			s += "; ";
 		}
 		
 		ASSERT(st.first != style_property::unknown)
 		
-		s << property_to_string(st.first) << ":";
+		s += property_to_string(st.first);
+		s += ':';
 		
-		s << style_value_to_string(st.first, st.second);
+		s += style_value_to_string(st.first, st.second, precision);
 	}
-	return s.str();
+	return s;
 }
 
 std::string styleable::classes_to_string()const{
-	std::stringstream ss;
+	std::string ret;
 
 	for(auto i = this->classes.begin(); i != this->classes.end(); ++i){
 		if(i != this->classes.begin()){
-			ss << " ";
+			ret += ' ';
 		}
-		ss << *i;
+		ret += *i;
 	}
 
-	return ss.str();
+	return ret;
 }
 
 // input parameter 'str' should have no leading or trailing white spaces
@@ -370,7 +377,7 @@ style_value parse_style_property_value(style_property type, utki::string_parser&
 }
 }
 
-decltype(styleable::styles) styleable::parse(const std::string& str){
+decltype(styleable::styles) styleable::parse(std::string_view str){
 	utki::string_parser p(str);
 	
 	p.skip_whitespaces();
@@ -507,7 +514,7 @@ const std::map<std::string_view, style_property> string_to_property_map = {
 }
 
 namespace{
-auto property_to_string_map = utki::flip_map(string_to_property_map);
+const auto property_to_string_map = utki::flip_map(string_to_property_map);
 }
 
 style_property styleable::string_to_property(std::string_view str){
@@ -527,6 +534,54 @@ std::string_view styleable::property_to_string(style_property p){
 	return std::string_view();
 }
 
+styleable::styleable(const styleable& s) :
+		cssom::styleable(s),
+		styles(s.styles),
+		presentation_attributes(s.presentation_attributes),
+		classes(s.classes),
+		deferred(s.deferred ? std::make_unique<deferred_attributes>(*s.deferred) : nullptr)
+{}
+
+styleable& styleable::operator=(const styleable& s){
+	this->cssom::styleable::operator=(s);
+	this->styles = s.styles;
+	this->presentation_attributes = s.presentation_attributes;
+	this->classes = s.classes;
+	this->deferred = s.deferred ? std::make_unique<deferred_attributes>(*s.deferred) : nullptr;
+	return *this;
+}
+
+style_map styleable::parse_deferred_styles()const{
+	auto ret = this->styles;
+	if(this->deferred && !this->deferred->style.empty()){
+		for(auto& v : parse(this->deferred->style)){
+			ret.insert(std::move(v));
+		}
+	}
+	return ret;
+}
+
+style_map styleable::parse_deferred_presentation_attributes()const{
+	auto ret = this->presentation_attributes;
+	if(this->deferred){
+		// in case of duplicate attributes the last one wins, as when parsing right away
+		const auto& attrs = this->deferred->presentation_attributes;
+		for(auto i = attrs.rbegin(); i != attrs.rend(); ++i){
+			ret.insert(std::make_pair(i->first, parse_style_property_value(i->first, i->second)));
+		}
+	}
+	return ret;
+}
+
+void styleable::parse_deferred(){
+	if(!this->deferred){
+		return;
+	}
+	this->styles = this->parse_deferred_styles();
+	this->presentation_attributes = this->parse_deferred_presentation_attributes();
+	this->deferred.reset();
+}
+
 const style_value* styleable::get_style_property(style_property p)const{
 	auto i = this->styles.find(p);
 	if(i != this->styles.end()){
@@ -729,7 +784,7 @@ const auto color_to_color_name_map = utki::flip_map(color_name_to_color_map);
 }
 
 namespace{
-std::map<std::string_view, display> string_to_display_map = {
+const std::map<std::string_view, display> string_to_display_map = {
 	{"inline", svgdom::display::inline_},
 	{"block", svgdom::display::block},
 	{"list-item", svgdom::display::list_item},
@@ -751,7 +806,7 @@ std::map<std::string_view, display> string_to_display_map = {
 }
 
 namespace{
-auto display_to_string_map = utki::flip_map(string_to_display_map);
+const auto display_to_string_map = utki::flip_map(string_to_display_map);
 }
 
 style_value svgdom::parse_display(std::string_view& str){
@@ -766,7 +821,7 @@ style_value svgdom::parse_display(std::string_view& str){
 }
 
 std::string_view svgdom::display_to_string(const style_value& v){
-	const auto& default_value = display_to_string_map[svgdom::display::inline_];
+	const auto& default_value = display_to_string_map.at(svgdom::display::inline_);
 
 	if(!std::holds_alternative<svgdom::display>(v)){
 		return default_value;
@@ -780,7 +835,7 @@ std::string_view svgdom::display_to_string(const style_value& v){
 }
 
 namespace{
-std::map<std::string_view, visibility> string_to_visibility_map = {
+const std::map<std::string_view, visibility> string_to_visibility_map = {
 	{"visible", visibility::visible},
 	{"hidden", visibility::hidden},
 	{"collapse", visibility::collapse}
@@ -788,7 +843,7 @@ std::map<std::string_view, visibility> string_to_visibility_map = {
 }
 
 namespace{
-auto visibility_to_string_map = utki::flip_map(string_to_visibility_map);
+const auto visibility_to_string_map = utki::flip_map(string_to_visibility_map);
 }
 
 style_value svgdom::parse_visibility(std::string_view str){
@@ -803,7 +858,7 @@ style_value svgdom::parse_visibility(std::string_view str){
 }
 
 std::string_view svgdom::visibility_to_string(const style_value& v){
-	const auto& default_value = visibility_to_string_map[svgdom::visibility::visible];
+	const auto& default_value = visibility_to_string_map.at(svgdom::visibility::visible);
 
 	if(!std::holds_alternative<svgdom::visibility>(v)){
 		return default_value;
@@ -900,7 +955,7 @@ style_value svgdom::parse_enable_background(std::string_view str){
 	return style_value(ebp);
 }
 
-std::string svgdom::enable_background_to_string(const style_value& v){
+std::string svgdom::enable_background_to_string(const style_value& v, unsigned precision){
 	const std::string& default_value = "accumulate";
 
 	if(!std::holds_alternative<svgdom::enable_background_property>(v)){
@@ -915,18 +970,22 @@ std::string svgdom::enable_background_to_string(const style_value& v){
 			return default_value;
 		case svgdom::enable_background::new_:
 			{
-				std::stringstream ss;
+				std::string ret;
 				
-				ss << "new";
+				ret += "new";
 				
 				if(ebp.is_rect_specified()){
-					ss << " " << ebp.rect.p.x();
-					ss << " " << ebp.rect.p.y();
-					ss << " " << ebp.rect.d.x();
-					ss << " " << ebp.rect.d.y();
+					ret += ' ';
+					append_number(ret, ebp.rect.p.x(), precision);
+					ret += ' ';
+					append_number(ret, ebp.rect.p.y(), precision);
+					ret += ' ';
+					append_number(ret, ebp.rect.d.x(), precision);
+					ret += ' ';
+					append_number(ret, ebp.rect.d.y(), precision);
 				}
 				
-				return ss.str();
+				return ret;
 			}
 	}
 }
@@ -1135,9 +1194,7 @@ std::string svgdom::paint_to_string(const style_value& v){
 				return std::string();
 		}
 	}else if(std::holds_alternative<std::string>(v)){ // URL
-		std::stringstream ss;
-		ss << "url(" << *std::get_if<std::string>(&v) << ")";
-		return ss.str();
+		return "url(" + *std::get_if<std::string>(&v) + ")";
 	}else if(std::holds_alternative<uint32_t>(v)){
 		auto i = color_to_color_name_map.find(*std::get_if<uint32_t>(&v));
 		if(i != color_to_color_name_map.end()){
@@ -1147,16 +1204,15 @@ std::string svgdom::paint_to_string(const style_value& v){
 		}else{
 			// #-notation
 
-			std::stringstream s;
-			s << std::hex;
-			s << "#";
-			s << ((*std::get_if<uint32_t>(&v) >> 4) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v)) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v) >> 12) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v) >> 8) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v) >> 20) & 0xf);
-			s << ((*std::get_if<uint32_t>(&v) >> 16) & 0xf);
-			return s.str();
+			const char* hex_digits = "0123456789abcdef";
+			auto c = *std::get_if<uint32_t>(&v);
+
+			// color is stored as 0xBBGGRR, write it as #rrggbb
+			std::string s = "#";
+			for(unsigned shift : {4, 0, 12, 8, 20, 16}){
+				s += hex_digits[(c >> shift) & 0xf];
+			}
+			return s;
 		}
 	}
 	return std::string();
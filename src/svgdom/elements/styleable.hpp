@@ -28,6 +28,7 @@ SOFTWARE.
 #pragma once
 
 #include <map>
+#include <memory>
 #include <vector>
 #include <variant>
 
@@ -237,7 +238,7 @@ style_value parse_visibility(std::string_view str);
 std::string_view visibility_to_string(const style_value& v);
 	
 style_value parse_enable_background(std::string_view str);
-std::string enable_background_to_string(const style_value& v);
+std::string enable_background_to_string(const style_value& v, unsigned precision = 6);
 	
 std::string color_interpolation_filters_to_string(const style_value& v);
 
@@ -267,15 +268,178 @@ style_value make_style_value(uint8_t r, uint8_t g, uint8_t b);
 style_value make_style_value(const r4::vector3<real>& rgb);
 
 
+/**
+ * @brief Map of style property values.
+ * A replacement for std::map<style_property, style_value> which keeps the values
+ * in a vector sorted by the property. A bit mask of present properties makes
+ * lookups cheap: missing property is detected by a single bit test and index of present
+ * property in the vector is the number of present properties which go before it.
+ * Iteration yields std::pair<style_property, style_value> in the order of properties, as std::map does.
+ * The property, i.e. the 'first' member of the pair, must not be changed through iterators.
+ */
+class style_map{
+public:
+	typedef style_property key_type;
+	typedef style_value mapped_type;
+	typedef std::pair<style_property, style_value> value_type;
+
+	typedef std::vector<value_type>::iterator iterator;
+	typedef std::vector<value_type>::const_iterator const_iterator;
+private:
+	static_assert(size_t(style_property::ENUM_SIZE) <= 64, "style properties do not fit into 64 bit mask");
+
+	std::vector<value_type> values;
+	uint64_t mask = 0;
+
+	static uint64_t to_bit(style_property p)noexcept{
+		return uint64_t(1) << unsigned(p);
+	}
+
+	static unsigned popcount(uint64_t x)noexcept{
+		x = x - ((x >> 1) & 0x5555555555555555);
+		x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333);
+		x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;
+		return unsigned((x * 0x0101010101010101) >> 56);
+	}
+
+	size_t index_of(style_property p)const noexcept{
+		return popcount(this->mask & (to_bit(p) - 1));
+	}
+public:
+	iterator begin()noexcept{
+		return this->values.begin();
+	}
+
+	iterator end()noexcept{
+		return this->values.end();
+	}
+
+	const_iterator begin()const noexcept{
+		return this->values.begin();
+	}
+
+	const_iterator end()const noexcept{
+		return this->values.end();
+	}
+
+	const_iterator cbegin()const noexcept{
+		return this->values.cbegin();
+	}
+
+	const_iterator cend()const noexcept{
+		return this->values.cend();
+	}
+
+	size_t size()const noexcept{
+		return this->values.size();
+	}
+
+	bool empty()const noexcept{
+		return this->values.empty();
+	}
+
+	void clear()noexcept{
+		this->values.clear();
+		this->mask = 0;
+	}
+
+	size_t count(style_property p)const noexcept{
+		return (this->mask & to_bit(p)) ? 1 : 0;
+	}
+
+	iterator find(style_property p)noexcept{
+		if(!(this->mask & to_bit(p))){
+			return this->end();
+		}
+		return this->begin() + this->index_of(p);
+	}
+
+	const_iterator find(style_property p)const noexcept{
+		if(!(this->mask & to_bit(p))){
+			return this->end();
+		}
+		return this->begin() + this->index_of(p);
+	}
+
+	/**
+	 * @brief Insert value if the property is not yet in the map.
+	 * @param v - property and value to insert.
+	 * @return pair of iterator to the property value and boolean which is true if the value was inserted.
+	 */
+	std::pair<iterator, bool> insert(value_type v){
+		auto i = this->begin() + this->index_of(v.first);
+		if(this->mask & to_bit(v.first)){
+			return std::make_pair(i, false);
+		}
+		this->mask |= to_bit(v.first);
+		return std::make_pair(this->values.insert(i, std::move(v)), true);
+	}
+
+	style_value& operator[](style_property p){
+		return this->insert(value_type(p, style_value())).first->second;
+	}
+
+	size_t erase(style_property p){
+		auto i = this->find(p);
+		if(i == this->end()){
+			return 0;
+		}
+		this->erase(i);
+		return 1;
+	}
+
+	iterator erase(const_iterator i){
+		this->mask &= ~to_bit(i->first);
+		return this->values.erase(i);
+	}
+};
+
 /**
  * @brief An element which has 'style' attribute or can be styled.
  */
 struct styleable : public cssom::styleable{
-	std::map<style_property, style_value> styles;
-	std::map<style_property, style_value> presentation_attributes;
+	style_map styles;
+	style_map presentation_attributes;
 
 	std::vector<std::string> classes;
 
+	typedef std::vector<std::pair<style_property, std::string>> presentation_attributes_text;
+
+	/**
+	 * @brief Unparsed text of attributes.
+	 * Holds attributes of an element loaded with load_options::lazy_parsing until parse_deferred() is called.
+	 */
+	struct deferred_attributes{
+		/**
+		 * @brief Text of the 'style' attribute.
+		 */
+		std::string style;
+
+		/**
+		 * @brief Style properties and text of the presentation attributes, in document order.
+		 */
+		presentation_attributes_text presentation_attributes;
+
+		/**
+		 * @brief Text of the 'd' attribute of 'path' element or 'points' attribute of 'polyline' and 'polygon' elements.
+		 */
+		std::string geometry;
+	};
+
+	/**
+	 * @brief Unparsed attributes.
+	 * Null unless the element was loaded with load_options::lazy_parsing and parse_deferred() has not been called yet.
+	 */
+	std::unique_ptr<deferred_attributes> deferred;
+
+	styleable() = default;
+
+	styleable(const styleable& s);
+	styleable& operator=(const styleable& s);
+
+	styleable(styleable&&) = default;
+	styleable& operator=(styleable&&) = default;
+
 	utki::span<const std::string> get_classes()const override{
 		return utki::make_span(this->classes);
 	}
@@ -288,11 +452,13 @@ struct styleable : public cssom::styleable{
 
 	std::string classes_to_string()const;
 
-	std::string styles_to_string()const;
+	std::string styles_to_string(unsigned precision = 6)const;
+
+	static std::string styles_to_string(const style_map& styles, unsigned precision = 6);
 
-	static std::string style_value_to_string(style_property p, const style_value& v);
+	static std::string style_value_to_string(style_property p, const style_value& v, unsigned precision = 6);
 
-	static decltype(styles) parse(const std::string& str);
+	static decltype(styles) parse(std::string_view str);
 
 	static style_value parse_style_property_value(style_property type, std::string_view str);
 
@@ -300,6 +466,29 @@ struct styleable : public cssom::styleable{
 
 	static std::string_view property_to_string(style_property p);
 	static style_property string_to_property(std::string_view str);
+
+	/**
+	 * @brief Get 'styles' with the deferred 'style' attribute text parsed.
+	 * Does not modify the element. Properties already present in 'styles' take precedence
+	 * over the ones from the deferred text.
+	 * @return style properties as they will be after parse_deferred().
+	 */
+	style_map parse_deferred_styles()const;
+
+	/**
+	 * @brief Get 'presentation_attributes' with the deferred presentation attributes text parsed.
+	 * Does not modify the element. Properties already present in 'presentation_attributes' take precedence
+	 * over the ones from the deferred text.
+	 * @return presentation attributes as they will be after parse_deferred().
+	 */
+	style_map parse_deferred_presentation_attributes()const;
+
+	/**
+	 * @brief Parse deferred attributes.
+	 * Parses the text held by 'deferred' into the corresponding members and resets 'deferred'.
+	 * Does nothing if 'deferred' is null.
+	 */
+	virtual void parse_deferred();
 };
 
 }
@@ -56,6 +56,14 @@ public:
 		return this->id;
 	}
 
+	const container* get_container()const noexcept override{
+		return this;
+	}
+
+	const styleable* get_styleable()const noexcept override{
+		return this;
+	}
+
 	static const std::string tag;
 
 	const std::string& get_tag()const override{
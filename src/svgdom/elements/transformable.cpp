@@ -33,8 +33,8 @@ SOFTWARE.
 
 using namespace svgdom;
 
-std::string transformable::transformations_to_string()const{
-	std::stringstream s;
+std::string transformable::transformations_to_string(unsigned precision)const{
+	std::string s;
 
 	bool isFirst = true;
 
@@ -42,7 +42,7 @@ std::string transformable::transformations_to_string()const{
 		if(isFirst){
 			isFirst = false;
 		}else{
-			s << " ";
+			s += ' ';
 		}
 
 		switch(t.type_){
@@ -50,39 +50,63 @@ std::string transformable::transformations_to_string()const{
 				ASSERT(false)
 				break;
 			case transformation::type::matrix:
-				s << "matrix(" << t.a << "," << t.b << "," << t.c << "," << t.d << "," << t.e << "," << t.f << ")";
+				s += "matrix(";
+				append_number(s, t.a, precision);
+				s += ',';
+				append_number(s, t.b, precision);
+				s += ',';
+				append_number(s, t.c, precision);
+				s += ',';
+				append_number(s, t.d, precision);
+				s += ',';
+				append_number(s, t.e, precision);
+				s += ',';
+				append_number(s, t.f, precision);
+				s += ')';
 				break;
 			case transformation::type::translate:
-				s << "translate(" << t.x;
+				s += "translate(";
+				append_number(s, t.x, precision);
 				if(t.y != 0){
-					s << "," << t.y;
+					s += ',';
+					append_number(s, t.y, precision);
 				}
-				s << ")";
+				s += ')';
 				break;
 			case transformation::type::scale:
-				s << "scale(" << t.x;
+				s += "scale(";
+				append_number(s, t.x, precision);
 				if(t.x != t.y){
-					s << "," << t.y;
+					s += ',';
+					append_number(s, t.y, precision);
 				}
-				s << ")";
+				s += ')';
 				break;
 			case transformation::type::rotate:
-				s << "rotate(" << t.angle;
+				s += "rotate(";
+				append_number(s, t.angle, precision);
 				if(t.x != 0 || t.y != 0){
-					s << "," << t.x << "," << t.y;
+					s += ',';
+					append_number(s, t.x, precision);
+					s += ',';
+					append_number(s, t.y, precision);
 				}
-				s << ")";
+				s += ')';
 				break;
 			case transformation::type::skewx:
-				s << "skewX(" << t.angle << ")";
+				s += "skewX(";
+				append_number(s, t.angle, precision);
+				s += ')';
 				break;
 			case transformation::type::skewy:
-				s << "skewY(" << t.angle << ")";
+				s += "skewY(";
+				append_number(s, t.angle, precision);
+				s += ')';
 				break;
 		}
 	}
 
-	return s.str();
+	return s;
 }
 
 decltype(transformable::transformations) transformable::parse(std::string_view str){
@@ -70,7 +70,7 @@ struct transformable{
 
 	std::vector<transformation> transformations;
 	
-	std::string transformations_to_string()const;
+	std::string transformations_to_string(unsigned precision = 6)const;
 	
 	static decltype(transformable::transformations) parse(std::string_view str);
 };
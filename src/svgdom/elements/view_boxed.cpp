@@ -50,17 +50,17 @@ decltype(view_boxed::view_box) view_boxed::parse_view_box(std::string_view str){
 	return ret;
 }
 
-std::string view_boxed::view_box_to_string()const{
-	std::stringstream s;
+std::string view_boxed::view_box_to_string(unsigned precision)const{
+	std::string s;
 	bool isFirst = true;
 	for (auto i = this->view_box.begin(); i != this->view_box.end(); ++i) {
 		if (isFirst) {
 			isFirst = false;
 		}
 		else {
-			s << " ";
+			s += ' ';
 		}
-		s << (*i);
+		append_number(s, *i, precision);
 	}
-	return s.str();
+	return s;
 }
@@ -41,7 +41,7 @@ namespace svgdom{
 struct view_boxed{
 	std::array<real, 4> view_box{{-1, -1, -1, -1}};
 
-	std::string view_box_to_string()const;
+	std::string view_box_to_string(unsigned precision = 6)const;
 
 	static decltype(view_box) parse_view_box(std::string_view str);
 
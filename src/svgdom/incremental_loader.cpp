@@ -0,0 +1,80 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "incremental_loader.hpp"
+
+#include <stdexcept>
+
+#include "parser.hxx"
+
+using namespace svgdom;
+
+incremental_loader::incremental_loader(size_t bytes_total, const load_options& options) :
+		p(std::make_unique<svgdom::parser>(options)),
+		bytes_total(bytes_total)
+{}
+
+incremental_loader::~incremental_loader()noexcept{}
+
+void incremental_loader::feed(utki::span<const char> data){
+	if(this->ended){
+		throw std::logic_error("incremental_loader::feed(): loading has already ended");
+	}
+	this->p->feed(data);
+	this->bytes_fed += data.size();
+}
+
+void incremental_loader::end(){
+	if(this->ended){
+		throw std::logic_error("incremental_loader::end(): loading has already ended");
+	}
+	this->p->end();
+	this->ended = true;
+}
+
+const svg_element* incremental_loader::peek_dom()const noexcept{
+	return this->p->peek_dom();
+}
+
+utki::span<const element* const> incremental_loader::get_open_elements()const noexcept{
+	return this->p->get_open_elements();
+}
+
+incremental_loader::progress incremental_loader::get_progress()const noexcept{
+	return progress{
+		this->bytes_fed,
+		this->bytes_total,
+		this->p->get_num_elements()
+	};
+}
+
+std::unique_ptr<svg_element> incremental_loader::get_dom(){
+	if(!this->ended){
+		throw std::logic_error("incremental_loader::get_dom(): loading has not ended yet, call end() first");
+	}
+	return this->p->get_dom();
+}
@@ -0,0 +1,158 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <memory>
+#include <algorithm>
+
+#include <utki/span.hpp>
+
+#include "dom.hpp"
+
+namespace svgdom{
+
+class parser;
+
+/**
+ * @brief Incremental SVG document loader.
+ * Loads SVG document from data chunks, as those become available, e.g. when downloading
+ * the document from network. Between the chunks the partially built document tree
+ * can be inspected.
+ */
+class incremental_loader{
+public:
+	/**
+	 * @brief Loading progress.
+	 */
+	struct progress{
+		/**
+		 * @brief Number of bytes fed to the loader so far.
+		 */
+		size_t bytes_fed;
+
+		/**
+		 * @brief Expected size of the document in bytes.
+		 * 0 if unknown.
+		 */
+		size_t bytes_total;
+
+		/**
+		 * @brief Number of elements parsed so far.
+		 */
+		size_t num_elements;
+
+		/**
+		 * @brief Loading progress ratio.
+		 * @return value from 0 to 1, the part of the expected document size fed so far.
+		 * @return 0 if the expected document size is unknown.
+		 */
+		float get_ratio()const noexcept{
+			if(this->bytes_total == 0){
+				return 0;
+			}
+			return std::min(float(this->bytes_fed) / float(this->bytes_total), 1.0f);
+		}
+	};
+
+	/**
+	 * @brief Constructor.
+	 * @param bytes_total - expected size of the document in bytes, used for progress reporting. 0 if unknown.
+	 * @param options - loading options.
+	 */
+	incremental_loader(size_t bytes_total = 0, const load_options& options = load_options());
+
+	incremental_loader(const incremental_loader&) = delete;
+	incremental_loader& operator=(const incremental_loader&) = delete;
+
+	~incremental_loader()noexcept;
+
+	/**
+	 * @brief Feed next chunk of SVG data.
+	 * @param data - chunk of SVG data.
+	 * @throw malformed_svg_error - in case the SVG document is malformed.
+	 */
+	void feed(utki::span<const char> data);
+
+	/**
+	 * @brief Feed next chunk of SVG data.
+	 * @param data - chunk of SVG data.
+	 * @throw malformed_svg_error - in case the SVG document is malformed.
+	 */
+	void feed(utki::span<const uint8_t> data){
+		this->feed(utki::make_span(reinterpret_cast<const char*>(data.data()), data.size()));
+	}
+
+	/**
+	 * @brief Finish loading.
+	 * Must be called after all the SVG data is fed to the loader.
+	 * @throw malformed_svg_error - in case the SVG document is malformed.
+	 */
+	void end();
+
+	/**
+	 * @brief Get partially built document tree.
+	 * The tree contains all the elements parsed so far. Elements which are not open,
+	 * see get_open_elements(), are parsed completely, together with their children.
+	 * Open elements have all their attributes parsed, but more children can be added to them
+	 * by subsequent feed() calls. Elements are never removed or moved by feed(), so pointers
+	 * to the elements remain valid, but children lists of open elements change.
+	 * @return pointer to the root element of the document tree.
+	 * @return nullptr if root element is not parsed yet or if the tree was taken with get_dom().
+	 */
+	const svg_element* peek_dom()const noexcept;
+
+	/**
+	 * @brief Get open elements.
+	 * Open elements are elements whose closing tag is not parsed yet.
+	 * @return open elements, from the root element down to the innermost open element.
+	 */
+	utki::span<const element* const> get_open_elements()const noexcept;
+
+	/**
+	 * @brief Get loading progress.
+	 * @return loading progress.
+	 */
+	progress get_progress()const noexcept;
+
+	/**
+	 * @brief Get loaded document.
+	 * Can only be called after end(). Moves the document tree out of the loader.
+	 * @return unique pointer to the root of SVG document tree.
+	 */
+	std::unique_ptr<svg_element> get_dom();
+
+private:
+	std::unique_ptr<svgdom::parser> p;
+
+	size_t bytes_fed = 0;
+	const size_t bytes_total;
+
+	bool ended = false;
+};
+
+}
@@ -98,45 +98,36 @@ real length::to_px(real dpi) const noexcept{
 	}
 }
 
-std::ostream& operator<<(std::ostream& s, const length& l){
-	s << l.value;
-	
-	switch(l.unit){
+std::string_view svgdom::length_unit_to_string(length_unit u){
+	switch(u){
 		case length_unit::unknown:
 		case length_unit::number:
 		default:
-			break;
+			return std::string_view();
 		case length_unit::percent:
-			s << "%";
-			break;
+			return "%";
 		case length_unit::em:
-			s << "em";
-			break;
+			return "em";
 		case length_unit::ex:
-			s << "ex";
-			break;
+			return "ex";
 		case length_unit::px:
-			s << "px";
-			break;
+			return "px";
 		case length_unit::cm:
-			s << "cm";
-			break;
+			return "cm";
 		case length_unit::mm:
-			s << "mm";
-			break;
+			return "mm";
 		case length_unit::in:
-			s << "in";
-			break;
+			return "in";
 		case length_unit::pt:
-			s << "pt";
-			break;
+			return "pt";
 		case length_unit::pc:
-			s << "pc";
-			break;
+			return "pc";
 		case length_unit::dip:
-			s << "dip";
-			break;
+			return "dip";
 	}
-	
+}
+
+std::ostream& operator<<(std::ostream& s, const length& l){
+	s << l.value << svgdom::length_unit_to_string(l.unit);
 	return s;
 }
@@ -0,0 +1,126 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "mapped_file.hxx"
+
+#include <cstdint>
+
+#include <utki/config.hpp>
+
+#if M_OS == M_OS_WINDOWS
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+using namespace svgdom;
+
+#if M_OS == M_OS_WINDOWS
+
+mapped_file::mapped_file(const std::string& path)noexcept{
+	HANDLE file = CreateFileA(
+			path.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr
+		);
+	if(file == INVALID_HANDLE_VALUE){
+		return;
+	}
+
+	LARGE_INTEGER file_size;
+	if(!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0 || uint64_t(file_size.QuadPart) > uint64_t(SIZE_MAX)){
+		CloseHandle(file);
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if(!mapping){
+		return;
+	}
+
+	// the view keeps the mapping object alive, so the handle can be closed right away
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(!view){
+		return;
+	}
+
+	this->data = static_cast<const char*>(view);
+	this->size = size_t(file_size.QuadPart);
+}
+
+mapped_file::~mapped_file()noexcept{
+	if(this->data){
+		UnmapViewOfFile(this->data);
+	}
+}
+
+#else
+
+mapped_file::mapped_file(const std::string& path)noexcept{
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0){
+		return;
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0){
+		close(fd);
+		return;
+	}
+
+	void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid after the file descriptor is closed
+	close(fd);
+
+	if(p == MAP_FAILED){
+		return;
+	}
+
+	// the parser goes through the data once from start to end
+	posix_madvise(p, size_t(st.st_size), POSIX_MADV_SEQUENTIAL);
+
+	this->data = static_cast<const char*>(p);
+	this->size = size_t(st.st_size);
+}
+
+mapped_file::~mapped_file()noexcept{
+	if(this->data){
+		munmap(const_cast<char*>(this->data), this->size);
+	}
+}
+
+#endif
@@ -0,0 +1,61 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <string>
+
+#include <utki/span.hpp>
+
+namespace svgdom{
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ * If the file cannot be mapped, e.g. because it is not a regular file or it is empty,
+ * then the object is created in unmapped state.
+ */
+class mapped_file{
+	const char* data = nullptr;
+	size_t size = 0;
+public:
+	mapped_file(const std::string& path)noexcept;
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	~mapped_file()noexcept;
+
+	bool is_mapped()const noexcept{
+		return this->data != nullptr;
+	}
+
+	utki::span<const char> span()const noexcept{
+		return utki::make_span(this->data, this->size);
+	}
+};
+
+}
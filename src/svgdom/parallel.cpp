@@ -0,0 +1,86 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "parallel.hxx"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <system_error>
+#include <algorithm>
+
+using namespace svgdom;
+
+unsigned svgdom::get_num_threads(unsigned num_threads){
+	if(num_threads == 0){
+		return std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	return num_threads;
+}
+
+void svgdom::run_tasks(size_t num_tasks, unsigned num_threads, const std::function<void(size_t)>& process_task){
+	num_threads = unsigned(std::min(size_t(num_threads), num_tasks));
+
+	std::vector<std::exception_ptr> errors(num_tasks);
+
+	std::atomic<size_t> next_index{0};
+
+	auto worker = [&](){
+		for(size_t i = next_index++; i < num_tasks; i = next_index++){
+			try{
+				process_task(i);
+			}catch(...){
+				errors[i] = std::current_exception();
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	if(num_threads > 1){
+		threads.reserve(num_threads - 1);
+		for(unsigned i = 1; i != num_threads; ++i){
+			try{
+				threads.emplace_back(worker);
+			}catch(std::system_error&){
+				break;
+			}
+		}
+	}
+
+	worker();
+
+	for(auto& t : threads){
+		t.join();
+	}
+
+	for(auto& e : errors){
+		if(e){
+			std::rethrow_exception(e);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <functional>
+
+namespace svgdom{
+
+// Work is split into several tasks per thread, to balance load when tasks differ in size.
+constexpr unsigned tasks_per_thread = 4;
+
+/**
+ * @brief Get number of threads to use.
+ * @param num_threads - requested number of threads, 0 means number of hardware threads.
+ * @return number of threads to use, at least 1.
+ */
+unsigned get_num_threads(unsigned num_threads);
+
+/**
+ * @brief Process tasks using several threads.
+ * Tasks are taken one at a time, so that threads which happened to get small tasks
+ * keep taking new ones while other threads are busy with big ones.
+ * The calling thread also processes tasks. If not all the threads could be started,
+ * the tasks are processed by the threads which were started.
+ * If any of the tasks throws, the rest of the tasks are still processed, then the exception
+ * of the task with the lowest index is rethrown.
+ * @param num_tasks - number of tasks.
+ * @param num_threads - maximum number of threads to use, including the calling thread.
+ * @param process_task - function processing the task of the given index.
+ */
+void run_tasks(size_t num_tasks, unsigned num_threads, const std::function<void(size_t)>& process_task);
+
+}
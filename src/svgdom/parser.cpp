@@ -29,14 +29,15 @@ SOFTWARE.
 #include "util.hxx"
 #include "malformed_svg_error.hpp"
 #include "util/casters.hpp"
+#include "arena.hxx"
 
 #include <utki/debug.hpp>
 #include <utki/util.hpp>
 #include <utki/string.hpp>
 
-#include <papki/span_file.hpp>
-
 #include <string_view>
+#include <type_traits>
+#include <algorithm>
 
 using namespace svgdom;
 
@@ -46,7 +47,7 @@ const std::string DXlinkNamespace = "http://www.w3.org/1999/xlink";
 }
 
 namespace{
-gradient::spread_method gradientStringToSpreadMethod(const std::string& str){
+gradient::spread_method gradientStringToSpreadMethod(std::string_view str){
 	if(str == "pad"){
 		return gradient::spread_method::pad;
 	}else if(str == "reflect"){
@@ -58,14 +59,76 @@ gradient::spread_method gradientStringToSpreadMethod(const std::string& str){
 }
 }
 
+parser::attribute_id parser::string_to_attribute_id(std::string_view name){
+	static const std::map<std::string_view, attribute_id> string_to_attribute_id_map = {
+		{"class", attribute_id::class_},
+		{"cx", attribute_id::cx},
+		{"cy", attribute_id::cy},
+		{"d", attribute_id::d},
+		{"filterUnits", attribute_id::filter_units},
+		{"fx", attribute_id::fx},
+		{"fy", attribute_id::fy},
+		{"gradientTransform", attribute_id::gradient_transform},
+		{"gradientUnits", attribute_id::gradient_units},
+		{"height", attribute_id::height},
+		{"href", attribute_id::href},
+		{"id", attribute_id::id},
+		{"in", attribute_id::in},
+		{"in2", attribute_id::in2},
+		{"k1", attribute_id::k1},
+		{"k2", attribute_id::k2},
+		{"k3", attribute_id::k3},
+		{"k4", attribute_id::k4},
+		{"maskContentUnits", attribute_id::mask_content_units},
+		{"maskUnits", attribute_id::mask_units},
+		{"mode", attribute_id::mode},
+		{"offset", attribute_id::offset},
+		{"operator", attribute_id::operator_},
+		{"points", attribute_id::points},
+		{"preserveAspectRatio", attribute_id::preserve_aspect_ratio},
+		{"primitiveUnits", attribute_id::primitive_units},
+		{"r", attribute_id::r},
+		{"result", attribute_id::result},
+		{"rx", attribute_id::rx},
+		{"ry", attribute_id::ry},
+		{"spreadMethod", attribute_id::spread_method},
+		{"stdDeviation", attribute_id::std_deviation},
+		{"style", attribute_id::style},
+		{"transform", attribute_id::transform},
+		{"type", attribute_id::type},
+		{"values", attribute_id::values},
+		{"viewBox", attribute_id::view_box},
+		{"width", attribute_id::width},
+		{"x", attribute_id::x},
+		{"x1", attribute_id::x1},
+		{"x2", attribute_id::x2},
+		{"xmlns", attribute_id::xmlns},
+		{"y", attribute_id::y},
+		{"y1", attribute_id::y1},
+		{"y2", attribute_id::y2}
+	};
+
+	auto i = string_to_attribute_id_map.find(name);
+	if(i != string_to_attribute_id_map.end()){
+		return i->second;
+	}
+	return attribute_id::unknown;
+}
+
 void parser::push_namespaces(){
 	// parse default namespace
 	{
-		auto i = this->attributes.find("xmlns");
+		auto i = std::find_if(
+				this->attributes.begin(),
+				this->attributes.end(),
+				[](const auto& a){
+					return a.prefix.empty() && a.id == attribute_id::xmlns;
+				}
+			);
 		if(i != this->attributes.end()){
-			if(i->second == DSvgNamespace){
+			if(i->value == DSvgNamespace){
 				this->default_namespace_stack.push_back(xml_namespace::svg);
-			}else if(i->second == DXlinkNamespace){
+			}else if(i->value == DXlinkNamespace){
 				this->default_namespace_stack.push_back(xml_namespace::xlink);
 			}else{
 				this->default_namespace_stack.push_back(xml_namespace::unknown);
@@ -81,28 +144,28 @@ void parser::push_namespaces(){
 	
 	//parse other namespaces
 	{
-		std::string xmlns = "xmlns:";
-		
 		this->namespace_stack.push_back(decltype(this->namespace_stack)::value_type());
 		
-		for(auto& e : this->attributes){
-			const auto& attr = e.first;
-			
-			if(attr.substr(0, xmlns.length()) != xmlns){
+		for(auto& a : this->attributes){
+			if(a.prefix != "xmlns"){
 				continue;
 			}
 			
-			ASSERT(attr.length() >= xmlns.length())
-			auto nsName = attr.substr(xmlns.length(), attr.length() - xmlns.length());
-			
-			if(e.second == DSvgNamespace){
-				this->namespace_stack.back()[nsName] = xml_namespace::svg;
-			}else if(e.second == DXlinkNamespace){
-				this->namespace_stack.back()[nsName] = xml_namespace::xlink;
+			if(a.value == DSvgNamespace){
+				this->namespace_stack.back()[std::string(a.name)] = xml_namespace::svg;
+			}else if(a.value == DXlinkNamespace){
+				this->namespace_stack.back()[std::string(a.name)] = xml_namespace::xlink;
 			}
 		}
-		
-		this->flipped_namespace_stack.push_back(utki::flip_map(this->namespace_stack.back()));
+	}
+
+	// resolve namespaces of the attributes
+	for(auto& a : this->attributes){
+		if(a.prefix.empty()){
+			a.ns = this->default_namespace_stack.back();
+		}else{
+			a.ns = this->find_namespace(a.prefix);
+		}
 	}
 }
 
@@ -111,8 +174,123 @@ void parser::pop_namespaces(){
 	this->namespace_stack.pop_back();
 	ASSERT(this->default_namespace_stack.size() != 0)
 	this->default_namespace_stack.pop_back();
-	ASSERT(this->flipped_namespace_stack.size() != 0)
-	this->flipped_namespace_stack.pop_back();
+}
+
+namespace{
+enum class element_kind{
+	unknown,
+	svg,
+	symbol,
+	g,
+	defs,
+	use,
+	path,
+	linear_gradient,
+	radial_gradient,
+	gradient_stop,
+	rect,
+	circle,
+	ellipse,
+	line,
+	polyline,
+	polygon,
+	filter,
+	fe_gaussian_blur,
+	fe_color_matrix,
+	fe_blend,
+	fe_composite,
+	image,
+	mask,
+	text,
+	style,
+
+	ENUM_SIZE
+};
+
+struct tag_entry{
+	std::string_view tag;
+	element_kind kind;
+};
+
+// NOTE: the tag strings must be the same as the 'tag' static members of the corresponding element classes.
+//       This is checked by assertions in the parse_*_element() functions.
+constexpr std::array<tag_entry, size_t(element_kind::ENUM_SIZE) - 1> tag_entries = {{
+	{"svg", element_kind::svg},
+	{"symbol", element_kind::symbol},
+	{"g", element_kind::g},
+	{"defs", element_kind::defs},
+	{"use", element_kind::use},
+	{"path", element_kind::path},
+	{"linearGradient", element_kind::linear_gradient},
+	{"radialGradient", element_kind::radial_gradient},
+	{"stop", element_kind::gradient_stop},
+	{"rect", element_kind::rect},
+	{"circle", element_kind::circle},
+	{"ellipse", element_kind::ellipse},
+	{"line", element_kind::line},
+	{"polyline", element_kind::polyline},
+	{"polygon", element_kind::polygon},
+	{"filter", element_kind::filter},
+	{"feGaussianBlur", element_kind::fe_gaussian_blur},
+	{"feColorMatrix", element_kind::fe_color_matrix},
+	{"feBlend", element_kind::fe_blend},
+	{"feComposite", element_kind::fe_composite},
+	{"image", element_kind::image},
+	{"mask", element_kind::mask},
+	{"text", element_kind::text},
+	{"style", element_kind::style}
+}};
+
+constexpr size_t tag_hash_table_size = 64;
+
+// the coefficients are selected so that the hash has no collisions on the known tags, this is checked by static_assert below
+constexpr size_t tag_hash(std::string_view tag){
+	if(tag.empty()){
+		return 0;
+	}
+	return (
+			tag.size() * 3
+					+ size_t(uint8_t(tag.front())) * 2
+					+ size_t(uint8_t(tag[tag.size() / 2])) * 2
+					+ size_t(uint8_t(tag.back()))
+		) % tag_hash_table_size;
+}
+
+constexpr bool is_tag_hash_perfect(){
+	for(size_t i = 0; i != tag_entries.size(); ++i){
+		for(size_t j = i + 1; j != tag_entries.size(); ++j){
+			if(tag_hash(tag_entries[i].tag) == tag_hash(tag_entries[j].tag)){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static_assert(is_tag_hash_perfect(), "tag hash has collisions, adjust the tag_hash() coefficients");
+
+// maps tag hash to index into the tag_entries plus 1, 0 means no tag
+constexpr auto tag_hash_table = [](){
+	std::array<uint8_t, tag_hash_table_size> ret{};
+	for(size_t i = 0; i != tag_entries.size(); ++i){
+		ret[tag_hash(tag_entries[i].tag)] = uint8_t(i + 1);
+	}
+	return ret;
+}();
+
+element_kind tag_to_element_kind(std::string_view tag){
+	auto index = tag_hash_table[tag_hash(tag)];
+	if(index == 0){
+		return element_kind::unknown;
+	}
+
+	const auto& e = tag_entries[index - 1];
+	if(e.tag != tag){
+		return element_kind::unknown;
+	}
+
+	return e.kind;
+}
 }
 
 void parser::parse_element(){
@@ -120,67 +298,95 @@ void parser::parse_element(){
 	// TRACE(<< "nsn.name = " << nsn.name << std::endl)
 	switch(nsn.ns){
 		case xml_namespace::svg:
-			if(nsn.name == svg_element::tag){
-				this->parse_svg_element();
-			}else if(nsn.name == symbol_element::tag){
-				this->parse_symbol_element();
-			}else if(nsn.name == g_element::tag){
-				this->parse_g_element();
-			}else if(nsn.name == defs_element::tag){
-				this->parse_defs_element();
-			}else if(nsn.name == use_element::tag){
-				this->parse_use_element();
-			}else if(nsn.name == path_element::tag){
-				this->parse_path_element();
-			}else if(nsn.name == linear_gradient_element::tag){
-				this->parse_linear_gradient_element();
-			}else if(nsn.name == radial_gradient_element::tag){
-				this->parse_radial_gradient_element();
-			}else if(nsn.name == gradient::stop_element::tag){
-				this->parse_gradient_stop_element();
-			}else if(nsn.name == rect_element::tag){
-				this->parse_rect_element();
-			}else if(nsn.name == circle_element::tag){
-				this->parse_circle_element();
-			}else if(nsn.name == ellipse_element::tag){
-				this->parse_ellipse_element();
-			}else if(nsn.name == line_element::tag){
-				this->parse_line_element();
-			}else if(nsn.name == polyline_element::tag){
-				this->parse_polyline_element();
-			}else if(nsn.name == polygon_element::tag){
-				this->parse_polygon_element();
-			}else if(nsn.name == filter_element::tag){
-				this->parse_filter_element();
-			}else if(nsn.name == fe_gaussian_blur_element::tag){
-				this->parse_fe_gaussian_blur_element();
-			}else if(nsn.name == fe_color_matrix_element::tag){
-				this->parse_fe_color_matrix_element();
-			}else if(nsn.name == fe_blend_element::tag){
-				this->parse_fe_blend_element();
-			}else if(nsn.name == fe_composite_element::tag){
-				this->parse_fe_composite_element();
-			}else if(nsn.name == image_element::tag){
-				this->parse_image_element();
-			}else if(nsn.name == mask_element::tag){
-				this->parse_mask_element();
-			}else if(nsn.name == text_element::tag){
-				this->parse_text_element();
-			}else if(nsn.name == style_element::tag){
-				this->parse_style_element();
-			}else{
-				// unknown element, ignore
-				break;
+			switch(tag_to_element_kind(nsn.name)){
+				case element_kind::svg:
+					this->parse_svg_element();
+					return;
+				case element_kind::symbol:
+					this->parse_symbol_element();
+					return;
+				case element_kind::g:
+					this->parse_g_element();
+					return;
+				case element_kind::defs:
+					this->parse_defs_element();
+					return;
+				case element_kind::use:
+					this->parse_use_element();
+					return;
+				case element_kind::path:
+					this->parse_path_element();
+					return;
+				case element_kind::linear_gradient:
+					this->parse_linear_gradient_element();
+					return;
+				case element_kind::radial_gradient:
+					this->parse_radial_gradient_element();
+					return;
+				case element_kind::gradient_stop:
+					this->parse_gradient_stop_element();
+					return;
+				case element_kind::rect:
+					this->parse_rect_element();
+					return;
+				case element_kind::circle:
+					this->parse_circle_element();
+					return;
+				case element_kind::ellipse:
+					this->parse_ellipse_element();
+					return;
+				case element_kind::line:
+					this->parse_line_element();
+					return;
+				case element_kind::polyline:
+					this->parse_polyline_element();
+					return;
+				case element_kind::polygon:
+					this->parse_polygon_element();
+					return;
+				case element_kind::filter:
+					this->parse_filter_element();
+					return;
+				case element_kind::fe_gaussian_blur:
+					this->parse_fe_gaussian_blur_element();
+					return;
+				case element_kind::fe_color_matrix:
+					this->parse_fe_color_matrix_element();
+					return;
+				case element_kind::fe_blend:
+					this->parse_fe_blend_element();
+					return;
+				case element_kind::fe_composite:
+					this->parse_fe_composite_element();
+					return;
+				case element_kind::image:
+					this->parse_image_element();
+					return;
+				case element_kind::mask:
+					this->parse_mask_element();
+					return;
+				case element_kind::text:
+					this->parse_text_element();
+					return;
+				case element_kind::style:
+					this->parse_style_element();
+					return;
+				default:
+					// unknown element, ignore
+					break;
 			}
-			return;
+			break;
 		default:
 			// unknown namespace, ignore
 			break;
 	}
+	if(auto stats = this->get_stats()){
+		++stats->num_unknown_elements;
+	}
 	this->element_stack.push_back(nullptr);
 }
 
-parser::xml_namespace parser::find_namespace(const std::string& ns){
+parser::xml_namespace parser::find_namespace(std::string_view ns){
 	for(auto i = this->namespace_stack.rbegin(), e = this->namespace_stack.rend(); i != e; ++i){
 		auto iter = i->find(ns);
 		if(iter == i->end()){
@@ -192,61 +398,36 @@ parser::xml_namespace parser::find_namespace(const std::string& ns){
 	return xml_namespace::unknown;
 }
 
-const std::string* parser::find_flipped_namespace(xml_namespace ns){
-	for(auto i = this->flipped_namespace_stack.rbegin(), e = this->flipped_namespace_stack.rend(); i != e; ++i){
-		auto iter = i->find(ns);
-		if(iter == i->end()){
-			continue;
-		}
-		ASSERT(ns == iter->first)
-		return &iter->second;
-	}
-	return nullptr;
-}
-
-parser::namespace_name_pair parser::get_namespace(const std::string& xmlName){
+parser::namespace_name_pair parser::get_namespace(std::string_view xml_name){
 	namespace_name_pair ret;
 
-	auto colonIndex = xmlName.find_first_of(':');
-	if(colonIndex == std::string::npos){
+	auto colon_index = xml_name.find(':');
+	if(colon_index == std::string_view::npos){
 		ret.ns = this->default_namespace_stack.back();
-		ret.name = xmlName;
+		ret.name = xml_name;
 		return ret;
 	}
 
-	ASSERT(xmlName.length() >= colonIndex + 1)
+	ASSERT(xml_name.length() >= colon_index + 1)
 
-	ret.ns = this->find_namespace(xmlName.substr(0, colonIndex));
-	ret.name = xmlName.substr(colonIndex + 1, xmlName.length() - 1 - colonIndex);
+	ret.ns = this->find_namespace(xml_name.substr(0, colon_index));
+	ret.name = xml_name.substr(colon_index + 1);
 
 	return ret;
 }
 
-const std::string* parser::find_attribute(const std::string& name){
-	auto i = this->attributes.find(name);
-	if(i != this->attributes.end()){
-		return &i->second;
-	}
-	return nullptr;
-}
-
-const std::string* parser::find_attribute_of_namespace(xml_namespace ns, const std::string& name){
-	if(this->default_namespace_stack.back() == ns){
-		if(auto a = this->find_attribute(name)){
-			return a;
-		}
-	}
-	
-	if(auto prefix = this->find_flipped_namespace(ns)){
-		if(auto a = this->find_attribute(*prefix + ":" + name)){
-			return a;
+const std::string_view* parser::find_attribute_of_namespace(xml_namespace ns, attribute_id id){
+	ASSERT(id != attribute_id::unknown)
+	for(auto& a : this->attributes){
+		if(a.id == id && a.ns == ns){
+			return &a.value;
 		}
 	}
 	return nullptr;
 }
 
 void parser::fill_element(element& e){
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "id")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::id)){
 		e.id = *a;
 	}
 }
@@ -256,13 +437,13 @@ void parser::fill_gradient(gradient& g){
 	this->fill_referencing(g);
 	this->fill_styleable(g);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "spreadMethod")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::spread_method)){
 		g.spread_method_ = gradientStringToSpreadMethod(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "gradientTransform")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::gradient_transform)){
 		g.transformations = transformable::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "gradientUnits")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::gradient_units)){
 		g.units = parse_coordinate_units(*a);
 	}
 }
@@ -270,24 +451,24 @@ void parser::fill_gradient(gradient& g){
 void parser::fill_rectangle(rectangle& r, const rectangle& defaultValues){
 	r = defaultValues;
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::x)){
 		r.x = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::y)){
 		r.y = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "width")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::width)){
 		r.width = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "height")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::height)){
 		r.height = length::parse(*a);
 	}
 }
 
 void parser::fill_referencing(referencing& e){
-	auto a = this->find_attribute_of_namespace(xml_namespace::xlink, "href");
+	auto a = this->find_attribute_of_namespace(xml_namespace::xlink, attribute_id::href);
 	if(!a){
-		a = this->find_attribute_of_namespace(xml_namespace::svg, "href");//in some SVG documents the svg namespace is used instead of xlink, though this is against SVG spec we allow to do so.
+		a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::href);//in some SVG documents the svg namespace is used instead of xlink, though this is against SVG spec we allow to do so.
 	}
 	if(a){
 		e.iri = *a;
@@ -300,30 +481,57 @@ void parser::fill_shape(shape& s){
 	this->fill_transformable(s);
 }
 
+namespace{
+// deferred attributes are only allocated for elements which have some
+styleable::deferred_attributes& get_deferred(styleable& s){
+	if(!s.deferred){
+		s.deferred = std::make_unique<styleable::deferred_attributes>();
+	}
+	return *s.deferred;
+}
+}
+
 void parser::fill_styleable(styleable& s){
 	ASSERT(s.styles.size() == 0)
 
+	auto stats = this->get_stats();
+	phase_timer timer(stats, &load_stats::phase_times::styles);
+
 	for(auto& a : this->attributes){
-		auto nsn = this->get_namespace(a.first);
-		switch (nsn.ns){
-			case xml_namespace::svg:
-				if(nsn.name == "style"){
-					s.styles = styleable::parse(a.second);
-					break;
-				}else if(nsn.name == "class"){
-					s.classes = utki::split(a.second);
-					break;
-				}
+		if(a.ns != xml_namespace::svg){
+			continue;
+		}
 
-				// parse style attributes
-				{
-					style_property type = styleable::string_to_property(nsn.name);
-					if(type != style_property::unknown){
-						s.presentation_attributes[type] = styleable::parse_style_property_value(type, a.second);
+		switch(a.id){
+			case attribute_id::style:
+				if(this->options.lazy_parsing){
+					get_deferred(s).style = a.value;
+				}else{
+					s.styles = styleable::parse(a.value);
+					if(stats){
+						stats->num_style_properties += s.styles.size();
 					}
 				}
 				break;
+			case attribute_id::class_:
+				s.classes = utki::split(a.value);
+				break;
 			default:
+				// parse style attributes
+				{
+					style_property type = styleable::string_to_property(a.name);
+					if(type == style_property::unknown){
+						break;
+					}
+					if(this->options.lazy_parsing){
+						get_deferred(s).presentation_attributes.emplace_back(type, a.value);
+					}else{
+						s.presentation_attributes[type] = styleable::parse_style_property_value(type, a.value);
+						if(stats){
+							++stats->num_style_properties;
+						}
+					}
+				}
 				break;
 		}
 	}
@@ -331,13 +539,13 @@ void parser::fill_styleable(styleable& s){
 
 void parser::fill_transformable(transformable& t){
 	ASSERT(t.transformations.size() == 0)
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "transform")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::transform)){
 		t.transformations = transformable::parse(*a);
 	}
 }
 
 void parser::fill_view_boxed(view_boxed& v){
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "viewBox")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::view_box)){
 		v.view_box = svg_element::parse_view_box(*a);
 	}
 }
@@ -351,13 +559,37 @@ void parser::fill_style(style_element& e){
 }
 
 void parser::fill_aspect_ratioed(aspect_ratioed& e){
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "preserveAspectRatio")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::preserve_aspect_ratio)){
 		e.preserve_aspect_ratio.parse(*a);
 	}
 }
 
+template <class element_type> std::unique_ptr<element_type> parser::make_element(){
+	// root element owns the arena, so it cannot be allocated from it
+	if(!this->options.use_arena || std::is_same<element_type, svg_element>::value){
+		if(auto stats = this->get_stats()){
+			++stats->num_element_allocations;
+		}
+		return std::make_unique<element_type>();
+	}
+
+	// arena allocated elements are told from the heap allocated ones by alignment, see element::operator delete()
+	static_assert(alignof(element_type) <= heap_alignment / 2, "element alignment is too big for arena allocation");
+
+	if(!this->arena){
+		this->arena = std::make_unique<svgdom::arena>();
+	}
+
+	return std::unique_ptr<element_type>(new(*this->arena) element_type());
+}
+
 void parser::add_element(std::unique_ptr<element> e){
 	ASSERT(e)
+
+	if(this->element_handler){
+		this->add_streamed_element(std::move(e));
+		return;
+	}
 	
 	auto elem = e.get();
 
@@ -386,24 +618,99 @@ void parser::add_element(std::unique_ptr<element> e){
 			elem = nullptr;
 		}
 	}
+	if(elem){
+		this->open_elements.push_back(elem);
+		++this->num_elements;
+		this->count_element(*elem);
+	}
+	this->element_stack.push_back(elem);
+}
+
+void parser::count_element(const element& e){
+	auto stats = this->get_stats();
+	if(!stats){
+		return;
+	}
+
+	++stats->num_elements;
+
+	const auto& tag = e.get_tag();
+	auto i = stats->elements_per_tag.find(tag);
+	if(i == stats->elements_per_tag.end()){
+		stats->elements_per_tag.emplace(tag, 1);
+	}else{
+		++i->second;
+	}
+}
+
+void parser::add_streamed_element(std::unique_ptr<element> e){
+	auto elem = e.get();
+
+	if(this->element_stack.empty()){
+		if(this->streamed_root_parsed){
+			throw malformed_svg_error("more than one root element found in the SVG document");
+		}
+
+		element_caster<svg_element> c;
+		e->accept(c);
+		if(!c.pointer){
+			throw malformed_svg_error("first element of the SVG document is not an 'svg' element");
+		}
+
+		this->streamed_root_parsed = true;
+	}else{
+		container_caster c;
+		auto parent = this->element_stack.back();
+		if(parent){
+			parent->accept(c);
+		}
+		if(!c.pointer){
+			// parent is not a container, ignore the element, the same way as when building the document tree
+			elem = nullptr;
+			e.reset();
+		}
+	}
+
+	if(elem){
+		this->streamed_elements.push_back(std::move(e));
+		this->open_elements.push_back(elem);
+		++this->num_elements;
+		this->count_element(*elem);
+	}
 	this->element_stack.push_back(elem);
 }
 
+void parser::end_streamed_element(){
+	ASSERT(!this->element_stack.empty())
+	if(!this->element_stack.back()){
+		return;
+	}
+
+	ASSERT(!this->streamed_elements.empty())
+	ASSERT(this->streamed_elements.back().get() == this->element_stack.back())
+
+	auto e = std::move(this->streamed_elements.back());
+	this->streamed_elements.pop_back();
+	this->open_elements.pop_back();
+
+	this->element_handler(*e, utki::make_span(this->open_elements));
+}
+
 void parser::parse_circle_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == circle_element::tag)
 
-	auto ret = std::make_unique<circle_element>();
+	auto ret = this->make_element<circle_element>();
 
 	this->fill_shape(*ret);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cx")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::cx)){
 		ret->cx = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cy")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::cy)){
 		ret->cy = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "r")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::r)){
 		ret->r = length::parse(*a);
 	}
 
@@ -414,7 +721,7 @@ void parser::parse_defs_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == defs_element::tag)
 
-	auto ret = std::make_unique<defs_element>();
+	auto ret = this->make_element<defs_element>();
 
 	this->fill_element(*ret);
 	this->fill_transformable(*ret);
@@ -427,17 +734,17 @@ void parser::parse_mask_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == mask_element::tag)
 
-	auto ret = std::make_unique<mask_element>();
+	auto ret = this->make_element<mask_element>();
 
 	this->fill_element(*ret);
 	this->fill_rectangle(*ret);
 	this->fill_styleable(*ret);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "maskUnits")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::mask_units)){
 		ret->mask_units = parse_coordinate_units(*a);
 	}
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "maskContentUnits")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::mask_content_units)){
 		ret->mask_content_units = parse_coordinate_units(*a);
 	}
 	
@@ -448,7 +755,7 @@ void parser::parse_text_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == text_element::tag)
 
-	auto ret = std::make_unique<text_element>();
+	auto ret = this->make_element<text_element>();
 
 	this->fill_element(*ret);
 	this->fill_styleable(*ret);
@@ -464,7 +771,7 @@ void parser::parse_style_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == style_element::tag)
 
-	auto ret = std::make_unique<style_element>();
+	auto ret = this->make_element<style_element>();
 
 	this->fill_element(*ret);
 	this->fill_style(*ret);
@@ -478,20 +785,20 @@ void parser::parse_ellipse_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == ellipse_element::tag)
 
-	auto ret = std::make_unique<ellipse_element>();
+	auto ret = this->make_element<ellipse_element>();
 
 	this->fill_shape(*ret);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cx")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::cx)){
 		ret->cx = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cy")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::cy)){
 		ret->cy = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "rx")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::rx)){
 		ret->rx = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "ry")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::ry)){
 		ret->ry = length::parse(*a);
 	}
 
@@ -502,7 +809,7 @@ void parser::parse_g_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == g_element::tag)
 
-	auto ret = std::make_unique<g_element>();
+	auto ret = this->make_element<g_element>();
 
 	this->fill_element(*ret);
 	this->fill_transformable(*ret);
@@ -515,11 +822,11 @@ void parser::parse_gradient_stop_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == gradient::stop_element::tag)
 
-	auto ret = std::make_unique<gradient::stop_element>();
+	auto ret = this->make_element<gradient::stop_element>();
 	
 	this->fill_styleable(*ret);
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "offset")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::offset)){
 		utki::string_parser p(*a);
 		ret->offset = p.read_number<real>();
 		if(!p.empty() && p.read_char() == '%'){
@@ -534,20 +841,20 @@ void parser::parse_line_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == line_element::tag)
 
-	auto ret = std::make_unique<line_element>();
+	auto ret = this->make_element<line_element>();
 
 	this->fill_shape(*ret);
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x1")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::x1)){
 		ret->x1 = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y1")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::y1)){
 		ret->y1 = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x2")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::x2)){
 		ret->x2 = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y2")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::y2)){
 		ret->y2 = length::parse(*a);
 	}
 
@@ -559,7 +866,7 @@ void parser::parse_filter_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == filter_element::tag)
 	
-	auto ret = std::make_unique<filter_element>();
+	auto ret = this->make_element<filter_element>();
 	
 	this->fill_element(*ret);
 	this->fill_styleable(*ret);
@@ -574,10 +881,10 @@ void parser::parse_filter_element(){
 		);
 	this->fill_referencing(*ret);
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "filterUnits")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::filter_units)){
 		ret->filter_units = svgdom::parse_coordinate_units(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "primitiveUnits")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::primitive_units)){
 		ret->primitive_units = svgdom::parse_coordinate_units(*a);
 	}
 	
@@ -589,19 +896,19 @@ void parser::fill_filter_primitive(filter_primitive& p){
 	this->fill_rectangle(p);
 	this->fill_styleable(p);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "result")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::result)){
 		p.result = *a;
 	}
 }
 
 void parser::fill_inputable(inputable& p){
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "in")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::in)){
 		p.in = *a;
 	}
 }
 
 void parser::fill_second_inputable(second_inputable& p){
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "in2")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::in2)){
 		p.in2 = *a;
 	}
 }
@@ -610,12 +917,12 @@ void parser::parse_fe_gaussian_blur_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == fe_gaussian_blur_element::tag)
 	
-	auto ret = std::make_unique<fe_gaussian_blur_element>();
+	auto ret = this->make_element<fe_gaussian_blur_element>();
 	
 	this->fill_filter_primitive(*ret);
 	this->fill_inputable(*ret);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "stdDeviation")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::std_deviation)){
 		ret->std_deviation = parse_number_and_optional_number(*a, {-1, -1});
 	}
 	
@@ -626,12 +933,12 @@ void parser::parse_fe_color_matrix_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == fe_color_matrix_element::tag)
 	
-	auto ret = std::make_unique<fe_color_matrix_element>();
+	auto ret = this->make_element<fe_color_matrix_element>();
 	
 	this->fill_filter_primitive(*ret);
 	this->fill_inputable(*ret);
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "type")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::type)){
 		if(*a == "saturate"){
 			ret->type_ = fe_color_matrix_element::type::saturate;
 		}else if(*a == "hueRotate"){
@@ -643,7 +950,7 @@ void parser::parse_fe_color_matrix_element(){
 		}
 	}
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "values")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::values)){
 		switch(ret->type_){
 			default:
 				ASSERT(false) // should never get here, MATRIX should always be the default value
@@ -677,13 +984,13 @@ void parser::parse_fe_blend_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == fe_blend_element::tag)
 	
-	auto ret = std::make_unique<fe_blend_element>();
+	auto ret = this->make_element<fe_blend_element>();
 	
 	this->fill_filter_primitive(*ret);
 	this->fill_inputable(*ret);
 	this->fill_second_inputable(*ret);
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "mode")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::mode)){
 		if(*a == "normal"){
 			ret->mode_ = fe_blend_element::mode::normal;
 		}else if(*a == "multiply"){
@@ -704,13 +1011,13 @@ void parser::parse_fe_composite_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == fe_composite_element::tag)
 	
-	auto ret = std::make_unique<fe_composite_element>();
+	auto ret = this->make_element<fe_composite_element>();
 	
 	this->fill_filter_primitive(*ret);
 	this->fill_inputable(*ret);
 	this->fill_second_inputable(*ret);
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "operator")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::operator_)){
 		if(*a == "over"){
 			ret->operator__ = fe_composite_element::operator_::over;
 		}else if(*a == "in"){
@@ -726,20 +1033,20 @@ void parser::parse_fe_composite_element(){
 		}
 	}
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "k1")){
-		ret->k1 = real(std::strtod(a->c_str(), nullptr));
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::k1)){
+		ret->k1 = real(std::strtod(std::string(*a).c_str(), nullptr));
 	}
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "k2")){
-		ret->k2 = real(std::strtod(a->c_str(), nullptr));
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::k2)){
+		ret->k2 = real(std::strtod(std::string(*a).c_str(), nullptr));
 	}
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "k3")){
-		ret->k3 = real(std::strtod(a->c_str(), nullptr));
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::k3)){
+		ret->k3 = real(std::strtod(std::string(*a).c_str(), nullptr));
 	}
 	
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "k4")){
-		ret->k4 = real(std::strtod(a->c_str(), nullptr));
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::k4)){
+		ret->k4 = real(std::strtod(std::string(*a).c_str(), nullptr));
 	}
 	
 	this->add_element(std::move(ret));
@@ -749,20 +1056,20 @@ void parser::parse_linear_gradient_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == linear_gradient_element::tag)
 
-	auto ret = std::make_unique<linear_gradient_element>();
+	auto ret = this->make_element<linear_gradient_element>();
 
 	this->fill_gradient(*ret);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x1")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::x1)){
 		ret->x1 = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y1")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::y1)){
 		ret->y1 = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x2")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::x2)){
 		ret->x2 = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y2")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::y2)){
 		ret->y2 = length::parse(*a);
 	}
 
@@ -773,12 +1080,25 @@ void parser::parse_path_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == path_element::tag)
 
-	auto ret = std::make_unique<path_element>();
+	auto ret = this->make_element<path_element>();
 
 	this->fill_shape(*ret);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "d")){
-		ret->path = path_element::parse(*a);
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::d)){
+		auto stats = this->get_stats();
+		if(stats){
+			stats->path_data_bytes += a->size();
+		}
+
+		if(this->options.lazy_parsing){
+			get_deferred(*ret).geometry = *a;
+		}else{
+			phase_timer timer(stats, &load_stats::phase_times::path_data);
+			ret->path = path_element::parse(*a);
+			if(stats){
+				stats->num_path_steps += ret->path.size();
+			}
+		}
 	}
 	
 	this->add_element(std::move(ret));
@@ -788,12 +1108,16 @@ void parser::parse_polygon_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == polygon_element::tag)
 
-	auto ret = std::make_unique<polygon_element>();
+	auto ret = this->make_element<polygon_element>();
 
 	this->fill_shape(*ret);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "points")){
-		ret->points = ret->parse(*a);
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::points)){
+		if(this->options.lazy_parsing){
+			get_deferred(*ret).geometry = *a;
+		}else{
+			ret->points = ret->parse(*a);
+		}
 	}
 	
 	this->add_element(std::move(ret));
@@ -803,12 +1127,16 @@ void parser::parse_polyline_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == polyline_element::tag)
 
-	auto ret = std::make_unique<polyline_element>();
+	auto ret = this->make_element<polyline_element>();
 
 	this->fill_shape(*ret);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "points")){
-		ret->points = ret->parse(*a);
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::points)){
+		if(this->options.lazy_parsing){
+			get_deferred(*ret).geometry = *a;
+		}else{
+			ret->points = ret->parse(*a);
+		}
 	}
 	
 	this->add_element(std::move(ret));
@@ -818,23 +1146,23 @@ void parser::parse_radial_gradient_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == radial_gradient_element::tag)
 
-	auto ret = std::make_unique<radial_gradient_element>();
+	auto ret = this->make_element<radial_gradient_element>();
 
 	this->fill_gradient(*ret);
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cx")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::cx)){
 		ret->cx = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cy")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::cy)){
 		ret->cy = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "r")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::r)){
 		ret->r = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "fx")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::fx)){
 		ret->fx = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "fy")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::fy)){
 		ret->fy = length::parse(*a);
 	}
 
@@ -845,15 +1173,15 @@ void parser::parse_rect_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == rect_element::tag)
 
-	auto ret = std::make_unique<rect_element>();
+	auto ret = this->make_element<rect_element>();
 
 	this->fill_shape(*ret);
 	this->fill_rectangle(*ret, rect_element::rectangle_default_values());
 
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "rx")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::rx)){
 		ret->rx = length::parse(*a);
 	}
-	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, "ry")){
+	if(auto a = this->find_attribute_of_namespace(xml_namespace::svg, attribute_id::ry)){
 		ret->ry = length::parse(*a);
 	}
 
@@ -864,7 +1192,7 @@ void parser::parse_svg_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == svg_element::tag)
 
-	auto ret = std::make_unique<svg_element>();
+	auto ret = this->make_element<svg_element>();
 
 	this->fill_element(*ret);
 	this->fill_styleable(*ret);
@@ -879,7 +1207,7 @@ void parser::parse_image_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == image_element::tag)
 
-	auto ret = std::make_unique<image_element>();
+	auto ret = this->make_element<image_element>();
 
 	this->fill_element(*ret);
 	this->fill_styleable(*ret);
@@ -897,7 +1225,7 @@ void parser::parse_symbol_element(){
 
 	//		TRACE(<< "parse_symbol_element():" << std::endl)
 
-	auto ret = std::make_unique<symbol_element>();
+	auto ret = this->make_element<symbol_element>();
 
 	this->fill_element(*ret);
 	this->fill_styleable(*ret);
@@ -911,7 +1239,7 @@ void parser::parse_use_element(){
 	ASSERT(this->get_namespace(this->cur_element).ns == xml_namespace::svg)
 	ASSERT(this->get_namespace(this->cur_element).name == use_element::tag)
 
-	auto ret = std::make_unique<use_element>();
+	auto ret = this->make_element<use_element>();
 
 	this->fill_element(*ret);
 	this->fill_transformable(*ret);
@@ -923,27 +1251,69 @@ void parser::parse_use_element(){
 }
 
 void parser::on_element_start(utki::span<const char> name){
-	this->cur_element = utki::make_string(name);
+	// assign() reuses the string's capacity, so no memory allocation is made for each element
+	this->cur_element.assign(name.data(), name.size());
 }
 
 void parser::on_element_end(utki::span<const char> name){
 	this->pop_namespaces();
+	if(this->element_handler){
+		this->end_streamed_element();
+	}else if(this->element_stack.back()){
+		ASSERT(!this->open_elements.empty())
+		this->open_elements.pop_back();
+	}
 	this->element_stack.pop_back();
 }
 
 void parser::on_attribute_parsed(utki::span<const char> name, utki::span<const char> value){
 	ASSERT(this->cur_element.length() != 0)
-	this->attributes[utki::make_string(name)] = utki::make_string(value);
+
+	auto name_begin = this->attributes_buf.size();
+	this->attributes_buf.insert(this->attributes_buf.end(), name.begin(), name.end());
+	auto value_begin = this->attributes_buf.size();
+	this->attributes_buf.insert(this->attributes_buf.end(), value.begin(), value.end());
+
+	this->attribute_offsets.push_back({{name_begin, value_begin, this->attributes_buf.size()}});
+}
+
+void parser::collect_attributes(){
+	ASSERT(this->attributes.empty())
+
+	std::string_view buf(this->attributes_buf.data(), this->attributes_buf.size());
+
+	for(const auto& o : this->attribute_offsets){
+		attribute a;
+
+		auto name = buf.substr(o[0], o[1] - o[0]);
+		auto colon_index = name.find(':');
+		if(colon_index == std::string_view::npos){
+			a.name = name;
+		}else{
+			a.prefix = name.substr(0, colon_index);
+			a.name = name.substr(colon_index + 1);
+		}
+		a.id = string_to_attribute_id(a.name);
+		a.value = buf.substr(o[1], o[2] - o[1]);
+
+		this->attributes.push_back(a);
+	}
 }
 
 void parser::on_attributes_end(bool is_empty_element){
 //	TRACE(<< "this->cur_element = " << this->cur_element << std::endl)
 //	TRACE(<< "this->element_stack.size() = " << this->element_stack.size() << std::endl)
+	phase_timer timer(this->get_stats(), &load_stats::phase_times::elements);
+
+	this->collect_attributes();
+
 	this->push_namespaces();
 
 	this->parse_element();
 
 	this->attributes.clear();
+	this->attribute_offsets.clear();
+	this->attributes_buf.clear();
 	this->cur_element.clear();
 }
 
@@ -960,21 +1330,7 @@ public:
 	}
 
 	void visit(style_element& e)override{
-		e.css.append(cssom::read(
-				papki::span_file(this->content),
-				[](const std::string& name) -> uint32_t{
-					return uint32_t(styleable::string_to_property(name));
-				},
-				[](uint32_t id, std::string&& v) -> std::unique_ptr<cssom::property_value_base>{
-					auto sp = style_property(id);
-					if(sp == style_property::unknown){
-						return nullptr;
-					}
-					auto ret = std::make_unique<style_element::css_style_value>();
-					ret->value = styleable::parse_style_property_value(sp, v);
-					return ret;
-				}
-			));
+		e.css.append(style_element::parse_css(std::string_view(this->content.data(), this->content.size())));
 	}
 };
 }
@@ -984,10 +1340,37 @@ void parser::on_content_parsed(utki::span<const char> str){
 		return;
 	}
 
+	phase_timer timer(this->get_stats(), &load_stats::phase_times::css);
+
 	parse_content_visitor v(str);
 	this->element_stack.back()->accept(v);
 }
 
+void parser::feed(utki::span<const char> data){
+	phase_timer timer(this->get_stats(), &load_stats::phase_times::total);
+	this->mikroxml::parser::feed(data);
+}
+
+void parser::end(){
+	{
+		phase_timer timer(this->get_stats(), &load_stats::phase_times::total);
+		this->mikroxml::parser::end();
+	}
+
+	if(auto stats = this->get_stats()){
+		auto& t = stats->time;
+		auto accounted = t.elements + t.css;
+		t.xml = t.total > accounted ? t.total - accounted : 0;
+
+		if(this->arena){
+			stats->num_element_allocations += this->arena->num_blocks();
+		}
+	}
+}
+
 std::unique_ptr<svg_element> parser::get_dom(){
+	if(this->svg && this->arena){
+		this->svg->element_arena = std::move(this->arena);
+	}
 	return std::move(this->svg);
 }
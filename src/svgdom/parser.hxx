@@ -30,6 +30,9 @@ SOFTWARE.
 #include <map>
 #include <vector>
 #include <memory>
+#include <array>
+#include <chrono>
+#include <string_view>
 
 #include <mikroxml/mikroxml.hpp>
 
@@ -46,48 +49,183 @@ SOFTWARE.
 #include "elements/text_element.hpp"
 #include "elements/style.hpp"
 
+#include "config.hpp"
+#include "dom.hpp"
+#include "arena.hxx"
+#include "stream_parser.hpp"
+
 namespace svgdom{
 
 class parser : public mikroxml::parser{
+	// arena to allocate elements from, declared first to outlive all the elements held by the parser,
+	// passed to the root element by get_dom()
+	std::unique_ptr<svgdom::arena> arena;
+
 	enum class xml_namespace{
 		unknown,
 		svg,
 		xlink
 	};
 	
+	/**
+	 * @brief Interned names of the attributes the parser looks up.
+	 * Presentation attributes are not listed here, those are resolved to style_property.
+	 */
+	enum class attribute_id{
+		unknown,
+		xmlns,
+		id,
+		class_,
+		style,
+		x,
+		y,
+		width,
+		height,
+		cx,
+		cy,
+		r,
+		rx,
+		ry,
+		fx,
+		fy,
+		x1,
+		y1,
+		x2,
+		y2,
+		d,
+		points,
+		href,
+		transform,
+		view_box,
+		preserve_aspect_ratio,
+		spread_method,
+		gradient_transform,
+		gradient_units,
+		offset,
+		mask_units,
+		mask_content_units,
+		filter_units,
+		primitive_units,
+		result,
+		in,
+		in2,
+		std_deviation,
+		type,
+		values,
+		mode,
+		operator_,
+		k1,
+		k2,
+		k3,
+		k4
+	};
+
+	static attribute_id string_to_attribute_id(std::string_view name);
+
 	std::vector<
-			std::map<std::string, xml_namespace>
+			std::map<std::string, xml_namespace, std::less<>>
 		> namespace_stack;
 	
-	std::vector<
-			std::map<xml_namespace, std::string>
-		> flipped_namespace_stack;
-	
 	std::vector<xml_namespace> default_namespace_stack;
 	
 	
-	xml_namespace find_namespace(const std::string& ns);
-	const std::string* find_flipped_namespace(xml_namespace ns);
+	xml_namespace find_namespace(std::string_view ns);
 	
 	struct namespace_name_pair{
 		xml_namespace ns;
-		std::string name;
+		std::string_view name;
 	};
 	
-	namespace_name_pair get_namespace(const std::string& xmlName);
-	
-	const std::string* find_attribute(const std::string& name);
+	namespace_name_pair get_namespace(std::string_view xml_name);
 	
-	const std::string* find_attribute_of_namespace(xml_namespace ns, const std::string& name);
+	const std::string_view* find_attribute_of_namespace(xml_namespace ns, attribute_id id);
 
 	void push_namespaces();
 	void pop_namespaces();
 	
 	std::string cur_element;
-	std::map<std::string, std::string> attributes;
+
+	/**
+	 * @brief Attribute of the element being parsed.
+	 * The strings are views into the attributes_buf.
+	 */
+	struct attribute{
+		xml_namespace ns = xml_namespace::unknown;
+		attribute_id id = attribute_id::unknown;
+		std::string_view prefix;
+		std::string_view name;
+		std::string_view value;
+	};
+
+	// mikroxml only guarantees that attribute name and value spans are valid during the
+	// on_attribute_parsed() call, so names and values are collected into a flat buffer.
+	// The buffer is reused from element to element, so in steady state no memory allocations
+	// are made for attributes. Only values which end up stored in the DOM are copied to strings.
+	std::vector<char> attributes_buf;
+
+	// name begin, value begin, value end offsets within the attributes_buf
+	std::vector<std::array<size_t, 3>> attribute_offsets;
+
+	std::vector<attribute> attributes;
+
+	void collect_attributes();
 	
+	const load_options options;
+
+	// statistics to gather, nullptr if not requested or if the instrumentation is compiled out
+	load_stats* get_stats()const noexcept{
+#if SVGDOM_STATS
+		return this->options.stats;
+#else
+		return nullptr;
+#endif
+	}
+
+	// adds time from construction to destruction to the phase time, if the statistics are gathered
+	class phase_timer{
+		uint64_t* const phase;
+		std::chrono::steady_clock::time_point start;
+	public:
+		phase_timer(load_stats* stats, uint64_t load_stats::phase_times::* phase) :
+				phase(stats ? &(stats->time.*phase) : nullptr)
+		{
+			if(this->phase){
+				this->start = std::chrono::steady_clock::now();
+			}
+		}
+
+		~phase_timer()noexcept{
+			if(this->phase){
+				*this->phase += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+						std::chrono::steady_clock::now() - this->start
+					).count());
+			}
+		}
+	};
+
+	void count_element(const element& e);
+
+
+	template <class element_type> std::unique_ptr<element_type> make_element();
+
 	std::unique_ptr<svg_element> svg; // root svg element
 	std::vector<element*> element_stack;
+
+	// open elements, unknown elements are not included
+	std::vector<const element*> open_elements;
+
+	// number of elements parsed so far, unknown elements are not counted
+	size_t num_elements = 0;
+
+	// if set, then elements are not added to the document tree, but given to the handler when closed
+	const stream_parser::element_handler element_handler;
+
+	// open elements in streaming mode, owned by the parser
+	std::vector<std::unique_ptr<element>> streamed_elements;
+	bool streamed_root_parsed = false;
+
+	void add_streamed_element(std::unique_ptr<element> e);
+	void end_streamed_element();
 	
 	void add_element(std::unique_ptr<element> e);
 	
@@ -147,7 +285,45 @@ class parser : public mikroxml::parser{
 	
 	void parse_element();
 public:
+	parser(const load_options& options = load_options()) :
+			options(options)
+	{
+		// reset also if the instrumentation is compiled out, so that the caller does not get stale values
+		if(this->options.stats){
+			*this->options.stats = load_stats();
+		}
+	}
+
+	parser(stream_parser::element_handler handler) :
+			element_handler(std::move(handler))
+	{}
+
+	void feed(utki::span<const char> data);
+
+	void feed(utki::span<const uint8_t> data){
+		this->feed(utki::make_span(reinterpret_cast<const char*>(data.data()), data.size()));
+	}
+
+	void end();
+
 	std::unique_ptr<svg_element> get_dom();
+
+	/**
+	 * @brief Get root element of the document tree being built.
+	 * @return pointer to the root element.
+	 * @return nullptr if root element is not parsed yet or the tree is already taken with get_dom().
+	 */
+	const svg_element* peek_dom()const noexcept{
+		return this->svg.get();
+	}
+
+	utki::span<const element* const> get_open_elements()const noexcept{
+		return utki::make_span(this->open_elements);
+	}
+
+	size_t get_num_elements()const noexcept{
+		return this->num_elements;
+	}
 };
 
 }
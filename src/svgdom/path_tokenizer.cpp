@@ -0,0 +1,229 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "path_tokenizer.hxx"
+
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <type_traits>
+
+#include <utki/string.hpp>
+
+using namespace svgdom;
+
+namespace{
+bool is_digit(char c)noexcept{
+	return '0' <= c && c <= '9';
+}
+
+// numbers with more significant digits than that go to the slow path
+constexpr unsigned max_mantissa_digits = std::numeric_limits<uint64_t>::digits10;
+
+// integers up to this value are exactly representable by T
+template <class T> constexpr uint64_t max_exact_mantissa = uint64_t(1) << std::numeric_limits<T>::digits;
+
+// largest power of ten which is exactly representable by T
+template <class T> constexpr unsigned max_exact_power_of_ten(){
+	// 10^n = 2^n * 5^n, so 10^n is exact as long as 5^n fits into the mantissa
+	unsigned n = 0;
+	for(uint64_t five_to_n = 5; five_to_n <= max_exact_mantissa<T>; five_to_n *= 5){
+		++n;
+	}
+	return n;
+}
+
+template <class T> constexpr std::array<T, 23> powers_of_ten = {{
+	T(1e0), T(1e1), T(1e2), T(1e3), T(1e4), T(1e5), T(1e6), T(1e7),
+	T(1e8), T(1e9), T(1e10), T(1e11), T(1e12), T(1e13), T(1e14), T(1e15),
+	T(1e16), T(1e17), T(1e18), T(1e19), T(1e20), T(1e21), T(1e22)
+}};
+
+// Both the mantissa and the power of ten are exactly representable, so
+// single multiplication or division gives correctly rounded result.
+template <class T> bool is_exact_fast_path(uint64_t mantissa, unsigned abs_exponent){
+	return mantissa <= max_exact_mantissa<T> && abs_exponent <= max_exact_power_of_ten<T>();
+}
+
+template <class T> T exact_fast_path(uint64_t mantissa, int exponent){
+	auto v = T(mantissa);
+	if(exponent < 0){
+		return v / powers_of_ten<T>[-exponent];
+	}
+	return v * powers_of_ten<T>[exponent];
+}
+
+// Converts correctly rounded double to float.
+// Returns false if the result could be affected by double rounding, i.e. the double lies exactly
+// in the middle between two floats. Otherwise there is no float between the exact value and the
+// double, so rounding the double gives the same float as rounding the exact value.
+bool double_to_float_exactly(double d, float& out){
+	using std::abs;
+	if(!(abs(d) >= double(std::numeric_limits<float>::min()) && abs(d) <= double(std::numeric_limits<float>::max()))){
+		return false;
+	}
+
+	uint64_t bits;
+	static_assert(sizeof(bits) == sizeof(d), "");
+	std::memcpy(&bits, &d, sizeof(d));
+
+	constexpr unsigned dropped_bits = std::numeric_limits<double>::digits - std::numeric_limits<float>::digits;
+	constexpr uint64_t dropped_mask = (uint64_t(1) << dropped_bits) - 1;
+	constexpr uint64_t midpoint = uint64_t(1) << (dropped_bits - 1);
+
+	if((bits & dropped_mask) == midpoint){
+		return false;
+	}
+
+	out = float(d);
+	return true;
+}
+static_assert(max_exact_power_of_ten<real>() < powers_of_ten<real>.size(), "powers_of_ten table is too short for the real type");
+static_assert(max_exact_power_of_ten<double>() < powers_of_ten<double>.size(), "powers_of_ten table is too short for double");
+}
+
+void path_tokenizer::skip_whitespaces_and_comma()noexcept{
+	this->skip_whitespaces();
+	if(this->p != this->end && *this->p == ','){
+		++this->p;
+		this->skip_whitespaces();
+	}
+}
+
+bool path_tokenizer::read_number(real& out)noexcept{
+	const char* s = this->p;
+
+	bool negative = false;
+	if(s != this->end && (*s == '-' || *s == '+')){
+		negative = *s == '-';
+		++s;
+	}
+
+	// mantissa can overflow here, this is checked by number of digits later
+	uint64_t mantissa = 0;
+	int exponent = 0;
+
+	const char* int_begin = s;
+
+	// leading zeros are not significant
+	while(s != this->end && *s == '0'){
+		++s;
+	}
+
+	const char* digits_begin = s;
+	for(; s != this->end && is_digit(*s); ++s){
+		mantissa = mantissa * 10 + unsigned(*s - '0');
+	}
+	size_t num_significant_digits = s - digits_begin;
+	bool has_digits = s != int_begin;
+
+	if(s != this->end && *s == '.'){
+		++s;
+		const char* frac_begin = s;
+
+		if(num_significant_digits == 0){
+			while(s != this->end && *s == '0'){
+				++s;
+			}
+		}
+
+		const char* frac_digits_begin = s;
+		for(; s != this->end && is_digit(*s); ++s){
+			mantissa = mantissa * 10 + unsigned(*s - '0');
+		}
+		num_significant_digits += s - frac_digits_begin;
+		exponent -= int(s - frac_begin);
+		has_digits = has_digits || s != frac_begin;
+	}
+
+	if(!has_digits){
+		return false;
+	}
+
+	if(s != this->end && (*s == 'e' || *s == 'E')){
+		const char* e = s + 1;
+
+		bool negative_exponent = false;
+		if(e != this->end && (*e == '-' || *e == '+')){
+			negative_exponent = *e == '-';
+			++e;
+		}
+
+		// if no digits follow, then the 'e' is not a part of the number
+		if(e != this->end && is_digit(*e)){
+			int exp = 0;
+			for(; e != this->end && is_digit(*e); ++e){
+				// huge exponents are out of range anyway, just avoid int overflow
+				if(exp < 10000){
+					exp = exp * 10 + (*e - '0');
+				}
+			}
+			exponent += negative_exponent ? -exp : exp;
+			s = e;
+		}
+	}
+
+	if(num_significant_digits <= max_mantissa_digits){
+		unsigned abs_exponent = exponent < 0 ? -exponent : exponent;
+
+		if(is_exact_fast_path<real>(mantissa, abs_exponent)){
+			auto v = exact_fast_path<real>(mantissa, exponent);
+			out = negative ? -v : v;
+			this->p = s;
+			return true;
+		}
+
+		// numbers with more digits than float can hold exactly are common in path data,
+		// those are converted through double
+		if constexpr (std::is_same<real, float>::value){
+			float v;
+			if(is_exact_fast_path<double>(mantissa, abs_exponent)
+					&& double_to_float_exactly(exact_fast_path<double>(mantissa, exponent), v)
+				)
+			{
+				out = negative ? -v : v;
+				this->p = s;
+				return true;
+			}
+		}
+	}
+
+	return this->read_number_slow(s, out);
+}
+
+bool path_tokenizer::read_number_slow(const char* token_end, real& out)noexcept{
+	try{
+		utki::string_parser sp(std::string_view(this->p, token_end - this->p));
+		out = sp.read_number<real>();
+	}catch(std::exception&){
+		return false;
+	}
+	this->p = token_end;
+	return true;
+}
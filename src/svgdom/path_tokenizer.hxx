@@ -0,0 +1,104 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <string_view>
+
+#include <utki/debug.hpp>
+
+#include "config.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Tokenizer for path data and point lists.
+ * Unlike utki::string_parser it does not throw exceptions,
+ * reading functions report failure through the return value instead.
+ */
+class path_tokenizer{
+	const char* p;
+	const char* const end;
+
+	bool read_number_slow(const char* token_end, real& out)noexcept;
+public:
+	path_tokenizer(std::string_view str) :
+			p(str.data()),
+			end(str.data() + str.size())
+	{}
+
+	bool empty()const noexcept{
+		return this->p == this->end;
+	}
+
+	char peek_char()const noexcept{
+		ASSERT(!this->empty())
+		return *this->p;
+	}
+
+	void skip_char()noexcept{
+		ASSERT(!this->empty())
+		++this->p;
+	}
+
+	static bool is_space(char c)noexcept{
+		return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+	}
+
+	void skip_whitespaces()noexcept{
+		while(this->p != this->end && is_space(*this->p)){
+			++this->p;
+		}
+	}
+
+	void skip_whitespaces_and_comma()noexcept;
+
+	/**
+	 * @brief Read number.
+	 * @param out - where to store the number.
+	 * @return true if the number was read.
+	 * @return false if there is no valid number at the current position, nothing is consumed in this case.
+	 */
+	bool read_number(real& out)noexcept;
+
+	/**
+	 * @brief Read arc flag.
+	 * @param out - where to store the flag.
+	 * @return true if the flag was read.
+	 * @return false if there are no more characters.
+	 */
+	bool read_flag(bool& out)noexcept{
+		if(this->empty()){
+			return false;
+		}
+		out = *this->p != '0';
+		++this->p;
+		return true;
+	}
+};
+
+}
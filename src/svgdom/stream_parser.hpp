@@ -0,0 +1,104 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <memory>
+#include <functional>
+
+#include <utki/span.hpp>
+
+#include "elements/element.hpp"
+
+namespace svgdom{
+
+class parser;
+
+/**
+ * @brief Streaming SVG parser.
+ * Parses SVG document without building the document tree.
+ * Each element is given to the handler when its closing tag is parsed, and then it is deleted.
+ * Elements are fully parsed, i.e. the handler gets typed elements with all their attributes
+ * parsed, like path_element with its steps. Child elements are not added to their container
+ * elements, so the handler gets container elements with no children. Children are given to
+ * the handler before their parent. This way, the memory used by the parser is
+ * bounded by the depth of the document, not by its size.
+ *
+ * The document is checked the same way as when it is loaded with svgdom::load().
+ * Unknown elements and their children are ignored.
+ */
+class stream_parser{
+public:
+	/**
+	 * @brief Element handler.
+	 * @param e - parsed element. The element is deleted after the handler returns.
+	 * @param ancestors - open ancestors of the element, from the root element to the parent
+	 *                    of the element. The ancestors have all their attributes parsed,
+	 *                    but no children.
+	 */
+	typedef std::function<void(element& e, utki::span<const element* const> ancestors)> element_handler;
+
+	/**
+	 * @brief Constructor.
+	 * @param handler - handler to give parsed elements to.
+	 */
+	stream_parser(element_handler handler);
+
+	stream_parser(const stream_parser&) = delete;
+	stream_parser& operator=(const stream_parser&) = delete;
+
+	~stream_parser()noexcept;
+
+	/**
+	 * @brief Feed next chunk of SVG data to the parser.
+	 * The handler is called from within this function for each element closed in the data chunk.
+	 * @param data - chunk of SVG data.
+	 * @throw malformed_svg_error - in case the SVG document is malformed.
+	 */
+	void feed(utki::span<const char> data);
+
+	/**
+	 * @brief Feed next chunk of SVG data to the parser.
+	 * @param data - chunk of SVG data.
+	 * @throw malformed_svg_error - in case the SVG document is malformed.
+	 */
+	void feed(utki::span<const uint8_t> data){
+		this->feed(utki::make_span(reinterpret_cast<const char*>(data.data()), data.size()));
+	}
+
+	/**
+	 * @brief Finish parsing.
+	 * Must be called after all the SVG data is fed to the parser.
+	 * @throw malformed_svg_error - in case the SVG document is malformed.
+	 */
+	void end();
+
+private:
+	std::unique_ptr<svgdom::parser> p;
+};
+
+}
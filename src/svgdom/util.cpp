@@ -28,11 +28,13 @@ SOFTWARE.
 #include "util.hxx"
 
 #include <utki/string.hpp>
+#include <utki/debug.hpp>
 
 #include <sstream>
 #include <cctype>
 #include <vector>
 #include <charconv>
+#include <limits>
 
 using namespace svgdom;
 
@@ -94,14 +96,110 @@ r4::vector2<real> svgdom::parse_number_and_optional_number(std::string_view s, r
 	return ret;
 }
 
-std::string svgdom::number_and_optional_number_to_string(std::array<real, 2> non, real optional_number_default){
-	std::stringstream ss;
+std::string svgdom::number_and_optional_number_to_string(std::array<real, 2> non, real optional_number_default, unsigned precision){
+	std::string ret;
 	
-	ss << non[0];
+	append_number(ret, non[0], precision);
 	
 	if(non[1] != optional_number_default){
-		ss << " " << non[1];
+		ret += ' ';
+		append_number(ret, non[1], precision);
 	}
 	
-	return ss.str();
+	return ret;
+}
+
+void svgdom::append_number(std::string& s, real v, unsigned precision){
+	// more digits than that do not make the number more precise
+	using std::min;
+	precision = min(precision, unsigned(std::numeric_limits<real>::max_digits10));
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	// std::ostream formats floating point numbers as printf's %g with precision 6,
+	// std::to_chars in general format gives exactly the same output
+	std::array<char, 32> buf; // enough for max_digits10 significant digits, sign, point and exponent
+	auto res = std::to_chars(buf.data(), buf.data() + buf.size(), v, std::chars_format::general, int(precision));
+	ASSERT(res.ec == std::errc())
+	s.append(buf.data(), res.ptr);
+#else
+	// no floating point std::to_chars, reuse the stream to avoid its construction for every number
+	thread_local std::ostringstream ss;
+	ss.str(std::string());
+	ss.precision(precision);
+	ss << v;
+	s += ss.str();
+#endif
+}
+
+void svgdom::shorten_number(std::string& s, size_t number_begin){
+	ASSERT(number_begin < s.size())
+
+	size_t i = number_begin;
+	if(s[i] == '-'){
+		if(s.size() - i == 2 && s[i + 1] == '0'){ // negative zero
+			s.erase(i, 1);
+			return;
+		}
+		++i;
+	}
+
+	// leading zero of the integer part, e.g. "0.5"
+	if(s.size() - i >= 2 && s[i] == '0' && s[i + 1] == '.'){
+		s.erase(i, 1);
+	}
+
+	auto e = s.find('e', i);
+	if(e == std::string::npos){
+		return;
+	}
+	size_t mantissa_end = e;
+	++e;
+
+	bool negative_exponent = false;
+	if(e != s.size() && s[e] == '+'){
+		s.erase(e, 1);
+	}else if(e != s.size() && s[e] == '-'){
+		negative_exponent = true;
+		++e;
+	}
+
+	// leading zeros of the exponent, at least one digit stays
+	size_t num_zeros = 0;
+	while(e + num_zeros + 1 < s.size() && s[e + num_zeros] == '0'){
+		++num_zeros;
+	}
+	s.erase(e, num_zeros);
+
+	if(negative_exponent){
+		return;
+	}
+
+	// positive exponent may be longer than trailing zeros, e.g. "1e2" vs "100"
+	std::string digits;
+	size_t point_pos = mantissa_end - i;
+	for(size_t j = i; j != mantissa_end; ++j){
+		if(s[j] == '.'){
+			point_pos = j - i;
+		}else{
+			digits += s[j];
+		}
+	}
+	point_pos += size_t(std::stoul(s.substr(e)));
+
+	if(point_pos < digits.size()){
+		digits.insert(point_pos, 1, '.');
+	}else if(point_pos - digits.size() > s.size() - i){
+		return; // too many zeros
+	}else{
+		digits.append(point_pos - digits.size(), '0');
+	}
+
+	if(digits.size() <= s.size() - i){
+		s.replace(i, std::string::npos, digits);
+	}
+}
+
+void svgdom::append_length(std::string& s, const length& l, unsigned precision){
+	append_number(s, l.value, precision);
+	s += length_unit_to_string(l.unit);
 }
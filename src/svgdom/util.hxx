@@ -36,6 +36,7 @@ SOFTWARE.
 #include <utki/string.hpp>
 
 #include "config.hpp"
+#include "length.hpp"
 #include "elements/coordinate_units.hpp"
 
 namespace svgdom{
@@ -50,6 +51,30 @@ std::string coordinate_units_to_string(coordinate_units u);
 
 r4::vector2<real> parse_number_and_optional_number(std::string_view s, r4::vector2<real> defaults);
 
-std::string number_and_optional_number_to_string(std::array<real, 2> non, real optional_number_default);
+std::string number_and_optional_number_to_string(std::array<real, 2> non, real optional_number_default, unsigned precision = 6);
+
+/**
+ * @brief Append number to string.
+ * The number is formatted the same way as std::ostream with default formatting flags does it,
+ * i.e. in general format with 6 significant digits by default, but without constructing a stream.
+ * @param s - string to append the number to.
+ * @param v - number to append.
+ * @param precision - number of significant digits.
+ */
+void append_number(std::string& s, real v, unsigned precision = 6);
+
+/**
+ * @brief Shorten the number formatted by append_number().
+ * Removes the leading zero of the integer part and redundant characters of the exponent,
+ * e.g. "-0.5" becomes "-.5", "1e-05" becomes "1e-5" and "1e+01" becomes "10".
+ * The number still parses to the same value.
+ * @param s - string which ends with the number.
+ * @param number_begin - position of the number in the string.
+ */
+void shorten_number(std::string& s, size_t number_begin);
+
+std::string_view length_unit_to_string(length_unit u);
+
+void append_length(std::string& s, const length& l, unsigned precision = 6);
 
 }
@@ -0,0 +1,97 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace svgdom{
+
+/*
+Binary document format.
+
+All multi-byte values are little-endian.
+
+Document starts with a header:
+	- 4 bytes of magic: 'S', 'V', 'G', 'B'
+	- format version, unsigned
+	- size of svgdom::real in bytes, 1 byte
+
+The header is followed by the root element. Each element starts with the element kind byte,
+followed by the element fields, see binary_writer for the exact order of the fields. Container
+elements then have number of children, unsigned, followed by the children.
+
+Encoding of values:
+	- unsigned: variable length, 7 bits per byte, least significant first, high bit set on all bytes but the last
+	- real: IEEE 754 binary representation of svgdom::real
+	- string: length in bytes, unsigned, followed by the string bytes
+	- symbol: string which is likely to repeat in the document, like id, class name, reference or
+	  filter result name. Symbols are numbered in order of their first appearance, starting from 1.
+	  Encoded as unsigned symbol number, or 0 followed by the string if the symbol appears first time.
+	- length: value as real, followed by unit as unsigned
+	- enumeration: unsigned
+*/
+namespace binary_format{
+
+constexpr std::array<char, 4> magic = {{'S', 'V', 'G', 'B'}};
+
+constexpr unsigned version = 2;
+
+enum class element_kind : uint8_t{
+	unknown,
+	path,
+	rect,
+	circle,
+	ellipse,
+	line,
+	polyline,
+	polygon,
+	g,
+	svg,
+	symbol,
+	use,
+	defs,
+	mask,
+	text,
+	style,
+	gradient_stop,
+	linear_gradient,
+	radial_gradient,
+	filter,
+	fe_gaussian_blur,
+	fe_color_matrix,
+	fe_blend,
+	fe_composite,
+	image,
+
+	ENUM_SIZE
+};
+
+}
+
+}
@@ -0,0 +1,620 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "binary_reader.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include <utki/debug.hpp>
+
+#include "binary_format.hxx"
+#include "casters.hpp"
+
+using namespace svgdom;
+
+namespace{
+typedef std::conditional<sizeof(real) == sizeof(uint32_t), uint32_t, uint64_t>::type real_bits_type;
+static_assert(sizeof(real) == sizeof(real_bits_type), "unsupported size of svgdom::real");
+}
+
+binary_reader::binary_reader(utki::span<const uint8_t> data) :
+		data(data)
+{
+	if(this->data.size() < binary_format::magic.size() ||
+			std::memcmp(this->data.data(), binary_format::magic.data(), binary_format::magic.size()) != 0
+		)
+	{
+		throw std::invalid_argument("binary_reader: data is not in binary document format");
+	}
+	this->pos = binary_format::magic.size();
+
+	if(this->read_unsigned() != binary_format::version){
+		throw std::invalid_argument("binary_reader: unsupported binary document format version");
+	}
+
+	if(this->read_byte() != sizeof(real)){
+		throw std::invalid_argument("binary_reader: binary document was written with different size of svgdom::real");
+	}
+}
+
+uint8_t binary_reader::read_byte(){
+	if(this->pos == this->data.size()){
+		throw std::invalid_argument("binary_reader: unexpected end of data");
+	}
+	return this->data[this->pos++];
+}
+
+uint64_t binary_reader::read_unsigned(){
+	uint64_t ret = 0;
+	for(unsigned shift = 0; shift < 64; shift += 7){
+		auto b = this->read_byte();
+		ret |= uint64_t(b & 0x7f) << shift;
+		if(!(b & 0x80)){
+			return ret;
+		}
+	}
+	throw std::invalid_argument("binary_reader: malformed unsigned number");
+}
+
+size_t binary_reader::read_size(){
+	auto ret = this->read_unsigned();
+
+	// every item takes at least one byte, so this check prevents from allocating memory for
+	// huge number of items in case of malformed data
+	if(ret > this->data.size() - this->pos){
+		throw std::invalid_argument("binary_reader: number of items exceeds data size");
+	}
+	return size_t(ret);
+}
+
+template <class enum_type> enum_type binary_reader::read_enum(enum_type max){
+	auto ret = this->read_unsigned();
+	if(ret > uint64_t(max)){
+		throw std::invalid_argument("binary_reader: enumeration value is out of range");
+	}
+	return enum_type(ret);
+}
+
+real binary_reader::read_real(){
+	if(this->data.size() - this->pos < sizeof(real)){
+		throw std::invalid_argument("binary_reader: unexpected end of data");
+	}
+
+	real_bits_type bits = 0;
+	for(unsigned i = 0; i != sizeof(bits); ++i){
+		bits |= real_bits_type(this->data[this->pos + i]) << (i * 8);
+	}
+	this->pos += sizeof(bits);
+
+	real ret;
+	std::memcpy(&ret, &bits, sizeof(ret));
+	return ret;
+}
+
+std::string binary_reader::read_string(){
+	auto size = this->read_size();
+	std::string ret(reinterpret_cast<const char*>(this->data.data() + this->pos), size);
+	this->pos += size;
+	return ret;
+}
+
+const std::string& binary_reader::read_symbol(){
+	auto num = this->read_unsigned();
+	if(num == 0){
+		this->symbols.push_back(this->read_string());
+		return this->symbols.back();
+	}
+	if(num > this->symbols.size()){
+		throw std::invalid_argument("binary_reader: symbol number is out of range");
+	}
+	return this->symbols[size_t(num - 1)];
+}
+
+length binary_reader::read_length(){
+	auto value = this->read_real();
+	return length(value, this->read_enum(length_unit::dip));
+}
+
+style_value binary_reader::read_style_value(){
+	static_assert(std::variant_size<style_value>::value == 13, "style_value alternatives changed, update binary format");
+
+	switch(this->read_unsigned()){
+		case 0:
+			return this->read_enum(style_value_special::inherit);
+		case 1:
+		{
+			auto v = this->read_unsigned();
+			if(v > uint64_t(std::numeric_limits<uint32_t>::max())){
+				throw std::invalid_argument("binary_reader: color value is out of range");
+			}
+			return uint32_t(v);
+		}
+		case 2:
+			return this->read_real();
+		case 3:
+			return this->read_length();
+		case 4:
+			return this->read_enum(stroke_line_cap::square);
+		case 5:
+			return this->read_enum(stroke_line_join::bevel);
+		case 6:
+			return this->read_enum(fill_rule::evenodd);
+		case 7:
+			return this->read_enum(color_interpolation::linear_rgb);
+		case 8:
+			return this->read_enum(display::none);
+		case 9:
+		{
+			enable_background_property ret;
+			ret.value = this->read_enum(enable_background::new_);
+			ret.rect.p.x() = this->read_real();
+			ret.rect.p.y() = this->read_real();
+			ret.rect.d.x() = this->read_real();
+			ret.rect.d.y() = this->read_real();
+			return ret;
+		}
+		case 10:
+			return this->read_enum(visibility::collapse);
+		case 11:
+			return this->read_string();
+		case 12:
+		{
+			std::vector<length> ret(this->read_size());
+			for(auto& l : ret){
+				l = this->read_length();
+			}
+			return ret;
+		}
+		default:
+			throw std::invalid_argument("binary_reader: style value of unknown type");
+	}
+}
+
+void binary_reader::read_element(element& e){
+	e.id = this->read_symbol();
+}
+
+void binary_reader::read_transformable(transformable& e){
+	using transformation = transformable::transformation;
+
+	e.transformations.resize(this->read_size());
+	for(auto& t : e.transformations){
+		t = transformation{};
+		t.type_ = this->read_enum(transformation::type::skewy);
+		switch(t.type_){
+			case transformation::type::matrix:
+				t.a = this->read_real();
+				t.b = this->read_real();
+				t.c = this->read_real();
+				t.d = this->read_real();
+				t.e = this->read_real();
+				t.f = this->read_real();
+				break;
+			case transformation::type::translate:
+			case transformation::type::scale:
+				t.x = this->read_real();
+				t.y = this->read_real();
+				break;
+			case transformation::type::rotate:
+				t.angle = this->read_real();
+				t.x = this->read_real();
+				t.y = this->read_real();
+				break;
+			case transformation::type::skewx:
+			case transformation::type::skewy:
+				t.angle = this->read_real();
+				break;
+		}
+	}
+}
+
+void binary_reader::read_styleable(styleable& e){
+	for(auto m : {&e.styles, &e.presentation_attributes}){
+		auto size = this->read_size();
+		for(size_t i = 0; i != size; ++i){
+			auto p = this->read_enum(style_property(unsigned(style_property::ENUM_SIZE) - 1));
+			(*m)[p] = this->read_style_value();
+		}
+	}
+
+	e.classes.resize(this->read_size());
+	for(auto& c : e.classes){
+		c = this->read_symbol();
+	}
+}
+
+void binary_reader::read_view_boxed(view_boxed& e){
+	for(auto& v : e.view_box){
+		v = this->read_real();
+	}
+}
+
+void binary_reader::read_aspect_ratioed(aspect_ratioed& e){
+	e.preserve_aspect_ratio.preserve = this->read_enum(aspect_ratioed::aspect_ratio_preservation::x_max_y_max);
+	auto flags = this->read_byte();
+	e.preserve_aspect_ratio.defer = (flags & 1) != 0;
+	e.preserve_aspect_ratio.slice = (flags & 2) != 0;
+}
+
+void binary_reader::read_rectangle(rectangle& e){
+	e.x = this->read_length();
+	e.y = this->read_length();
+	e.width = this->read_length();
+	e.height = this->read_length();
+}
+
+void binary_reader::read_shape(shape& e){
+	this->read_element(e);
+	this->read_transformable(e);
+	this->read_styleable(e);
+}
+
+void binary_reader::read_referencing(referencing& e){
+	e.iri = this->read_symbol();
+}
+
+void binary_reader::read_gradient(gradient& e){
+	this->read_element(e);
+	this->read_referencing(e);
+	this->read_transformable(e);
+	this->read_styleable(e);
+	e.spread_method_ = this->read_enum(gradient::spread_method::repeat);
+	e.units = this->read_enum(coordinate_units::object_bounding_box);
+}
+
+void binary_reader::read_filter_primitive(filter_primitive& e){
+	this->read_element(e);
+	this->read_rectangle(e);
+	this->read_styleable(e);
+	e.result = this->read_symbol();
+}
+
+void binary_reader::read_inputable(inputable& e){
+	e.in = this->read_symbol();
+}
+
+void binary_reader::read_second_inputable(second_inputable& e){
+	e.in2 = this->read_symbol();
+}
+
+void binary_reader::read_points(polyline_shape& e){
+	e.points.resize(this->read_size());
+	for(auto& p : e.points){
+		p.x() = this->read_real();
+		p.y() = this->read_real();
+	}
+}
+
+std::unique_ptr<element> binary_reader::read_node(open_container& oc){
+	auto read_children = [this, &oc](container& c){
+		oc.c = &c;
+		oc.num_children_left = this->read_size();
+	};
+
+	switch(this->read_enum(binary_format::element_kind(unsigned(binary_format::element_kind::ENUM_SIZE) - 1))){
+		case binary_format::element_kind::path:
+		{
+			auto e = std::make_unique<path_element>();
+			this->read_shape(*e);
+
+			auto commands_size = this->read_size();
+			std::vector<uint8_t> commands(
+					this->data.begin() + this->pos,
+					this->data.begin() + this->pos + commands_size
+				);
+			this->pos += commands_size;
+
+			std::vector<real> coordinates(this->read_size());
+			for(auto& c : coordinates){
+				c = this->read_real();
+			}
+
+			try{
+				e->path = compact_path(std::move(commands), std::move(coordinates)).to_steps();
+			}catch(std::invalid_argument& ex){
+				throw std::invalid_argument(std::string("binary_reader: malformed path: ") + ex.what());
+			}
+			return e;
+		}
+		case binary_format::element_kind::rect:
+		{
+			auto e = std::make_unique<rect_element>();
+			this->read_shape(*e);
+			this->read_rectangle(*e);
+			e->rx = this->read_length();
+			e->ry = this->read_length();
+			return e;
+		}
+		case binary_format::element_kind::circle:
+		{
+			auto e = std::make_unique<circle_element>();
+			this->read_shape(*e);
+			e->cx = this->read_length();
+			e->cy = this->read_length();
+			e->r = this->read_length();
+			return e;
+		}
+		case binary_format::element_kind::ellipse:
+		{
+			auto e = std::make_unique<ellipse_element>();
+			this->read_shape(*e);
+			e->cx = this->read_length();
+			e->cy = this->read_length();
+			e->rx = this->read_length();
+			e->ry = this->read_length();
+			return e;
+		}
+		case binary_format::element_kind::line:
+		{
+			auto e = std::make_unique<line_element>();
+			this->read_shape(*e);
+			e->x1 = this->read_length();
+			e->y1 = this->read_length();
+			e->x2 = this->read_length();
+			e->y2 = this->read_length();
+			return e;
+		}
+		case binary_format::element_kind::polyline:
+		{
+			auto e = std::make_unique<polyline_element>();
+			this->read_shape(*e);
+			this->read_points(*e);
+			return e;
+		}
+		case binary_format::element_kind::polygon:
+		{
+			auto e = std::make_unique<polygon_element>();
+			this->read_shape(*e);
+			this->read_points(*e);
+			return e;
+		}
+		case binary_format::element_kind::g:
+		{
+			auto e = std::make_unique<g_element>();
+			this->read_element(*e);
+			this->read_transformable(*e);
+			this->read_styleable(*e);
+			read_children(*e);
+			return e;
+		}
+		case binary_format::element_kind::svg:
+		{
+			auto e = std::make_unique<svg_element>();
+			this->read_element(*e);
+			this->read_rectangle(*e);
+			this->read_view_boxed(*e);
+			this->read_aspect_ratioed(*e);
+			this->read_styleable(*e);
+			read_children(*e);
+			return e;
+		}
+		case binary_format::element_kind::symbol:
+		{
+			auto e = std::make_unique<symbol_element>();
+			this->read_element(*e);
+			this->read_view_boxed(*e);
+			this->read_aspect_ratioed(*e);
+			this->read_styleable(*e);
+			read_children(*e);
+			return e;
+		}
+		case binary_format::element_kind::use:
+		{
+			auto e = std::make_unique<use_element>();
+			this->read_element(*e);
+			this->read_transformable(*e);
+			this->read_referencing(*e);
+			this->read_rectangle(*e);
+			this->read_styleable(*e);
+			return e;
+		}
+		case binary_format::element_kind::defs:
+		{
+			auto e = std::make_unique<defs_element>();
+			this->read_element(*e);
+			this->read_transformable(*e);
+			this->read_styleable(*e);
+			read_children(*e);
+			return e;
+		}
+		case binary_format::element_kind::mask:
+		{
+			auto e = std::make_unique<mask_element>();
+			this->read_element(*e);
+			this->read_rectangle(*e);
+			this->read_styleable(*e);
+			e->mask_units = this->read_enum(coordinate_units::object_bounding_box);
+			e->mask_content_units = this->read_enum(coordinate_units::object_bounding_box);
+			read_children(*e);
+			return e;
+		}
+		case binary_format::element_kind::text:
+		{
+			auto e = std::make_unique<text_element>();
+			this->read_element(*e);
+			this->read_styleable(*e);
+			this->read_transformable(*e);
+			read_children(*e);
+			return e;
+		}
+		case binary_format::element_kind::style:
+		{
+			auto e = std::make_unique<style_element>();
+			this->read_element(*e);
+			e->css = style_element::parse_css(this->read_string());
+			return e;
+		}
+		case binary_format::element_kind::gradient_stop:
+		{
+			auto e = std::make_unique<gradient::stop_element>();
+			this->read_element(*e);
+			this->read_styleable(*e);
+			e->offset = this->read_real();
+			return e;
+		}
+		case binary_format::element_kind::linear_gradient:
+		{
+			auto e = std::make_unique<linear_gradient_element>();
+			this->read_gradient(*e);
+			e->x1 = this->read_length();
+			e->y1 = this->read_length();
+			e->x2 = this->read_length();
+			e->y2 = this->read_length();
+			read_children(*e);
+			return e;
+		}
+		case binary_format::element_kind::radial_gradient:
+		{
+			auto e = std::make_unique<radial_gradient_element>();
+			this->read_gradient(*e);
+			e->cx = this->read_length();
+			e->cy = this->read_length();
+			e->r = this->read_length();
+			e->fx = this->read_length();
+			e->fy = this->read_length();
+			read_children(*e);
+			return e;
+		}
+		case binary_format::element_kind::filter:
+		{
+			auto e = std::make_unique<filter_element>();
+			this->read_element(*e);
+			this->read_styleable(*e);
+			this->read_rectangle(*e);
+			this->read_referencing(*e);
+			e->filter_units = this->read_enum(coordinate_units::object_bounding_box);
+			e->primitive_units = this->read_enum(coordinate_units::object_bounding_box);
+			read_children(*e);
+			return e;
+		}
+		case binary_format::element_kind::fe_gaussian_blur:
+		{
+			auto e = std::make_unique<fe_gaussian_blur_element>();
+			this->read_filter_primitive(*e);
+			this->read_inputable(*e);
+			e->std_deviation.x() = this->read_real();
+			e->std_deviation.y() = this->read_real();
+			return e;
+		}
+		case binary_format::element_kind::fe_color_matrix:
+		{
+			auto e = std::make_unique<fe_color_matrix_element>();
+			this->read_filter_primitive(*e);
+			this->read_inputable(*e);
+			e->type_ = this->read_enum(fe_color_matrix_element::type::luminance_to_alpha);
+			for(auto& v : e->values){
+				v = this->read_real();
+			}
+			return e;
+		}
+		case binary_format::element_kind::fe_blend:
+		{
+			auto e = std::make_unique<fe_blend_element>();
+			this->read_filter_primitive(*e);
+			this->read_inputable(*e);
+			this->read_second_inputable(*e);
+			e->mode_ = this->read_enum(fe_blend_element::mode::lighten);
+			return e;
+		}
+		case binary_format::element_kind::fe_composite:
+		{
+			auto e = std::make_unique<fe_composite_element>();
+			this->read_filter_primitive(*e);
+			this->read_inputable(*e);
+			this->read_second_inputable(*e);
+			e->operator__ = this->read_enum(fe_composite_element::operator_::arithmetic);
+			e->k1 = this->read_real();
+			e->k2 = this->read_real();
+			e->k3 = this->read_real();
+			e->k4 = this->read_real();
+			return e;
+		}
+		case binary_format::element_kind::image:
+		{
+			auto e = std::make_unique<image_element>();
+			this->read_element(*e);
+			this->read_styleable(*e);
+			this->read_transformable(*e);
+			this->read_rectangle(*e);
+			this->read_referencing(*e);
+			this->read_aspect_ratioed(*e);
+			return e;
+		}
+		default:
+			throw std::invalid_argument("binary_reader: unknown element kind");
+	}
+}
+
+std::unique_ptr<element> binary_reader::read(){
+	// the tree is read without recursion, so that deep trees do not overflow the stack
+	std::vector<open_container> stack;
+
+	open_container oc;
+	auto ret = this->read_node(oc);
+	if(oc.num_children_left != 0){
+		stack.push_back(oc);
+	}
+
+	while(!stack.empty()){
+		auto& top = stack.back();
+		if(top.num_children_left == 0){
+			stack.pop_back();
+			continue;
+		}
+		--top.num_children_left;
+
+		auto parent = top.c;
+		ASSERT(parent)
+
+		open_container child_oc;
+		parent->children.push_back(this->read_node(child_oc));
+		if(child_oc.num_children_left != 0){
+			stack.push_back(child_oc);
+		}
+	}
+
+	if(this->pos != this->data.size()){
+		throw std::invalid_argument("binary_reader: unexpected data after the element tree");
+	}
+
+	return ret;
+}
+
+std::unique_ptr<svg_element> binary_reader::read_svg(){
+	auto e = this->read();
+
+	element_caster<svg_element> c;
+	e->accept(c);
+	if(!c.pointer){
+		throw std::invalid_argument("binary_reader: root element is not 'svg' element");
+	}
+	e.release();
+	return std::unique_ptr<svg_element>(c.pointer);
+}
@@ -0,0 +1,115 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <utki/span.hpp>
+
+#include "../elements/element.hpp"
+#include "../elements/container.hpp"
+#include "../elements/structurals.hpp"
+#include "../elements/shapes.hpp"
+#include "../elements/gradients.hpp"
+#include "../elements/filter.hpp"
+#include "../elements/image_element.hpp"
+#include "../elements/text_element.hpp"
+#include "../elements/style.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Reader of binary document format.
+ * Reads document tree written with binary_writer.
+ */
+class binary_reader{
+	utki::span<const uint8_t> data;
+	size_t pos = 0;
+
+	std::vector<std::string> symbols;
+
+	uint8_t read_byte();
+	uint64_t read_unsigned();
+	size_t read_size();
+	template <class enum_type> enum_type read_enum(enum_type max);
+	real read_real();
+	std::string read_string();
+	const std::string& read_symbol();
+	length read_length();
+	style_value read_style_value();
+
+	void read_element(element& e);
+	void read_transformable(transformable& e);
+	void read_styleable(styleable& e);
+	void read_view_boxed(view_boxed& e);
+	void read_aspect_ratioed(aspect_ratioed& e);
+	void read_rectangle(rectangle& e);
+	void read_shape(shape& e);
+	void read_referencing(referencing& e);
+	void read_gradient(gradient& e);
+	void read_filter_primitive(filter_primitive& e);
+	void read_inputable(inputable& e);
+	void read_second_inputable(second_inputable& e);
+	void read_points(polyline_shape& e);
+
+	struct open_container{
+		container* c = nullptr;
+		size_t num_children_left = 0;
+	};
+
+	std::unique_ptr<element> read_node(open_container& oc);
+
+public:
+	/**
+	 * @brief Constructor.
+	 * Checks the binary format header.
+	 * @param data - binary document data. The data must remain valid while reading.
+	 * @throw std::invalid_argument - if data is not in binary document format or
+	 *                                its version is not supported.
+	 */
+	binary_reader(utki::span<const uint8_t> data);
+
+	/**
+	 * @brief Read element tree.
+	 * The data must contain exactly one element tree.
+	 * @return root element of the tree.
+	 * @throw std::invalid_argument - if the data is malformed or there is data left after the element tree.
+	 */
+	std::unique_ptr<element> read();
+
+	/**
+	 * @brief Read SVG document.
+	 * @return root element of the document.
+	 * @throw std::invalid_argument - if the data is malformed or root element is not 'svg' element.
+	 */
+	std::unique_ptr<svg_element> read_svg();
+};
+
+}
@@ -0,0 +1,502 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "binary_writer.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "binary_format.hxx"
+
+using namespace svgdom;
+
+namespace{
+typedef std::conditional<sizeof(real) == sizeof(uint32_t), uint32_t, uint64_t>::type real_bits_type;
+static_assert(sizeof(real) == sizeof(real_bits_type), "unsupported size of svgdom::real");
+}
+
+binary_writer::binary_writer(std::ostream& s) :
+		s(s)
+{
+	this->s.write(binary_format::magic.data(), binary_format::magic.size());
+	this->write_unsigned(binary_format::version);
+	this->write_byte(uint8_t(sizeof(real)));
+}
+
+void binary_writer::write_byte(uint8_t v){
+	this->s.put(char(v));
+}
+
+void binary_writer::write_unsigned(uint64_t v){
+	while(v >= 0x80){
+		this->write_byte(uint8_t(v | 0x80));
+		v >>= 7;
+	}
+	this->write_byte(uint8_t(v));
+}
+
+void binary_writer::write_real(real v){
+	real_bits_type bits;
+	std::memcpy(&bits, &v, sizeof(v));
+
+	std::array<char, sizeof(bits)> buf;
+	for(auto& b : buf){
+		b = char(uint8_t(bits));
+		bits >>= 8;
+	}
+	this->s.write(buf.data(), buf.size());
+}
+
+void binary_writer::write_string(std::string_view str){
+	this->write_unsigned(str.size());
+	this->s.write(str.data(), str.size());
+}
+
+void binary_writer::write_symbol(std::string_view str){
+	auto i = this->symbols.insert(std::make_pair(std::string(str), this->symbols.size() + 1));
+	if(!i.second){
+		this->write_unsigned(i.first->second);
+		return;
+	}
+	this->write_unsigned(0);
+	this->write_string(str);
+}
+
+void binary_writer::write_length(const length& l){
+	this->write_real(l.value);
+	this->write_unsigned(unsigned(l.unit));
+}
+
+void binary_writer::write_style_value(const style_value& v){
+	this->write_unsigned(v.index());
+
+	if(auto p = std::get_if<style_value_special>(&v)){
+		this->write_unsigned(unsigned(*p));
+	}else if(auto p = std::get_if<uint32_t>(&v)){
+		this->write_unsigned(*p);
+	}else if(auto p = std::get_if<real>(&v)){
+		this->write_real(*p);
+	}else if(auto p = std::get_if<length>(&v)){
+		this->write_length(*p);
+	}else if(auto p = std::get_if<stroke_line_cap>(&v)){
+		this->write_unsigned(unsigned(*p));
+	}else if(auto p = std::get_if<stroke_line_join>(&v)){
+		this->write_unsigned(unsigned(*p));
+	}else if(auto p = std::get_if<fill_rule>(&v)){
+		this->write_unsigned(unsigned(*p));
+	}else if(auto p = std::get_if<color_interpolation>(&v)){
+		this->write_unsigned(unsigned(*p));
+	}else if(auto p = std::get_if<display>(&v)){
+		this->write_unsigned(unsigned(*p));
+	}else if(auto p = std::get_if<enable_background_property>(&v)){
+		this->write_unsigned(unsigned(p->value));
+		this->write_real(p->rect.p.x());
+		this->write_real(p->rect.p.y());
+		this->write_real(p->rect.d.x());
+		this->write_real(p->rect.d.y());
+	}else if(auto p = std::get_if<visibility>(&v)){
+		this->write_unsigned(unsigned(*p));
+	}else if(auto p = std::get_if<std::string>(&v)){
+		this->write_string(*p);
+	}else if(auto p = std::get_if<std::vector<length>>(&v)){
+		this->write_unsigned(p->size());
+		for(const auto& l : *p){
+			this->write_length(l);
+		}
+	}else{
+		throw std::invalid_argument("binary_writer: style value of unsupported type");
+	}
+}
+
+void binary_writer::write_kind(uint8_t kind){
+	this->write_byte(kind);
+}
+
+void binary_writer::write_children(const container& c){
+	this->write_unsigned(c.children.size());
+	this->relay_accept(c);
+}
+
+void binary_writer::write_element(const element& e){
+	this->write_symbol(e.id);
+}
+
+void binary_writer::write_transformable(const transformable& e){
+	using transformation = transformable::transformation;
+
+	this->write_unsigned(e.transformations.size());
+	for(const auto& t : e.transformations){
+		this->write_unsigned(unsigned(t.type_));
+		switch(t.type_){
+			case transformation::type::matrix:
+				this->write_real(t.a);
+				this->write_real(t.b);
+				this->write_real(t.c);
+				this->write_real(t.d);
+				this->write_real(t.e);
+				this->write_real(t.f);
+				break;
+			case transformation::type::translate:
+			case transformation::type::scale:
+				this->write_real(t.x);
+				this->write_real(t.y);
+				break;
+			case transformation::type::rotate:
+				this->write_real(t.angle);
+				this->write_real(t.x);
+				this->write_real(t.y);
+				break;
+			case transformation::type::skewx:
+			case transformation::type::skewy:
+				this->write_real(t.angle);
+				break;
+		}
+	}
+}
+
+void binary_writer::write_styleable(const styleable& e){
+	// the element is not modified, so deferred attributes are parsed into local copies
+	style_map deferred_styles;
+	style_map deferred_attributes;
+	if(e.deferred){
+		deferred_styles = e.parse_deferred_styles();
+		deferred_attributes = e.parse_deferred_presentation_attributes();
+	}
+	const auto& styles = e.deferred ? deferred_styles : e.styles;
+	const auto& attributes = e.deferred ? deferred_attributes : e.presentation_attributes;
+
+	for(const auto& m : {&styles, &attributes}){
+		this->write_unsigned(m->size());
+		for(const auto& p : *m){
+			this->write_unsigned(unsigned(p.first));
+			this->write_style_value(p.second);
+		}
+	}
+
+	this->write_unsigned(e.classes.size());
+	for(const auto& c : e.classes){
+		this->write_symbol(c);
+	}
+}
+
+void binary_writer::write_view_boxed(const view_boxed& e){
+	for(auto v : e.view_box){
+		this->write_real(v);
+	}
+}
+
+void binary_writer::write_aspect_ratioed(const aspect_ratioed& e){
+	this->write_unsigned(unsigned(e.preserve_aspect_ratio.preserve));
+	this->write_byte(
+			(e.preserve_aspect_ratio.defer ? 1 : 0) |
+			(e.preserve_aspect_ratio.slice ? 2 : 0)
+		);
+}
+
+void binary_writer::write_rectangle(const rectangle& e){
+	this->write_length(e.x);
+	this->write_length(e.y);
+	this->write_length(e.width);
+	this->write_length(e.height);
+}
+
+void binary_writer::write_shape(const shape& e){
+	this->write_element(e);
+	this->write_transformable(e);
+	this->write_styleable(e);
+}
+
+void binary_writer::write_referencing(const referencing& e){
+	this->write_symbol(e.iri);
+}
+
+void binary_writer::write_gradient(const gradient& e){
+	this->write_element(e);
+	this->write_referencing(e);
+	this->write_transformable(e);
+	this->write_styleable(e);
+	this->write_unsigned(unsigned(e.spread_method_));
+	this->write_unsigned(unsigned(e.units));
+}
+
+void binary_writer::write_filter_primitive(const filter_primitive& e){
+	this->write_element(e);
+	this->write_rectangle(e);
+	this->write_styleable(e);
+	this->write_symbol(e.result);
+}
+
+void binary_writer::write_inputable(const inputable& e){
+	this->write_symbol(e.in);
+}
+
+void binary_writer::write_second_inputable(const second_inputable& e){
+	this->write_symbol(e.in2);
+}
+
+void binary_writer::visit(const g_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::g));
+	this->write_element(e);
+	this->write_transformable(e);
+	this->write_styleable(e);
+	this->write_children(e);
+}
+
+void binary_writer::visit(const svg_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::svg));
+	this->write_element(e);
+	this->write_rectangle(e);
+	this->write_view_boxed(e);
+	this->write_aspect_ratioed(e);
+	this->write_styleable(e);
+	this->write_children(e);
+}
+
+void binary_writer::visit(const symbol_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::symbol));
+	this->write_element(e);
+	this->write_view_boxed(e);
+	this->write_aspect_ratioed(e);
+	this->write_styleable(e);
+	this->write_children(e);
+}
+
+void binary_writer::visit(const defs_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::defs));
+	this->write_element(e);
+	this->write_transformable(e);
+	this->write_styleable(e);
+	this->write_children(e);
+}
+
+void binary_writer::visit(const linear_gradient_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::linear_gradient));
+	this->write_gradient(e);
+	this->write_length(e.x1);
+	this->write_length(e.y1);
+	this->write_length(e.x2);
+	this->write_length(e.y2);
+	this->write_children(e);
+}
+
+void binary_writer::visit(const radial_gradient_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::radial_gradient));
+	this->write_gradient(e);
+	this->write_length(e.cx);
+	this->write_length(e.cy);
+	this->write_length(e.r);
+	this->write_length(e.fx);
+	this->write_length(e.fy);
+	this->write_children(e);
+}
+
+void binary_writer::visit(const gradient::stop_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::gradient_stop));
+	this->write_element(e);
+	this->write_styleable(e);
+	this->write_real(e.offset);
+}
+
+void binary_writer::visit(const use_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::use));
+	this->write_element(e);
+	this->write_transformable(e);
+	this->write_referencing(e);
+	this->write_rectangle(e);
+	this->write_styleable(e);
+}
+
+void binary_writer::visit(const path_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::path));
+	this->write_shape(e);
+
+	// path steps are stored packed, the same way as compact_path does
+	compact_path cp(e.deferred ? compact_path(e.parse_deferred_path()) : compact_path(e.path));
+
+	auto commands = cp.get_commands();
+	this->write_unsigned(commands.size());
+	this->s.write(reinterpret_cast<const char*>(commands.data()), commands.size());
+
+	auto coordinates = cp.get_coordinates();
+	this->write_unsigned(coordinates.size());
+	for(auto c : coordinates){
+		this->write_real(c);
+	}
+}
+
+void binary_writer::visit(const circle_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::circle));
+	this->write_shape(e);
+	this->write_length(e.cx);
+	this->write_length(e.cy);
+	this->write_length(e.r);
+}
+
+void binary_writer::write_points(const polyline_shape& e){
+	// the element is not modified, so deferred points are parsed into a local copy
+	decltype(e.points) deferred_points;
+	if(e.deferred){
+		deferred_points = e.parse_deferred_points();
+	}
+	const auto& points = e.deferred ? deferred_points : e.points;
+
+	this->write_unsigned(points.size());
+	for(const auto& p : points){
+		this->write_real(p.x());
+		this->write_real(p.y());
+	}
+}
+
+void binary_writer::visit(const polyline_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::polyline));
+	this->write_shape(e);
+	this->write_points(e);
+}
+
+void binary_writer::visit(const polygon_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::polygon));
+	this->write_shape(e);
+	this->write_points(e);
+}
+
+void binary_writer::visit(const ellipse_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::ellipse));
+	this->write_shape(e);
+	this->write_length(e.cx);
+	this->write_length(e.cy);
+	this->write_length(e.rx);
+	this->write_length(e.ry);
+}
+
+void binary_writer::visit(const rect_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::rect));
+	this->write_shape(e);
+	this->write_rectangle(e);
+	this->write_length(e.rx);
+	this->write_length(e.ry);
+}
+
+void binary_writer::visit(const line_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::line));
+	this->write_shape(e);
+	this->write_length(e.x1);
+	this->write_length(e.y1);
+	this->write_length(e.x2);
+	this->write_length(e.y2);
+}
+
+void binary_writer::visit(const filter_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::filter));
+	this->write_element(e);
+	this->write_styleable(e);
+	this->write_rectangle(e);
+	this->write_referencing(e);
+	this->write_unsigned(unsigned(e.filter_units));
+	this->write_unsigned(unsigned(e.primitive_units));
+	this->write_children(e);
+}
+
+void binary_writer::visit(const fe_gaussian_blur_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::fe_gaussian_blur));
+	this->write_filter_primitive(e);
+	this->write_inputable(e);
+	this->write_real(e.std_deviation.x());
+	this->write_real(e.std_deviation.y());
+}
+
+void binary_writer::visit(const fe_color_matrix_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::fe_color_matrix));
+	this->write_filter_primitive(e);
+	this->write_inputable(e);
+	this->write_unsigned(unsigned(e.type_));
+	for(auto v : e.values){
+		this->write_real(v);
+	}
+}
+
+void binary_writer::visit(const fe_blend_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::fe_blend));
+	this->write_filter_primitive(e);
+	this->write_inputable(e);
+	this->write_second_inputable(e);
+	this->write_unsigned(unsigned(e.mode_));
+}
+
+void binary_writer::visit(const fe_composite_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::fe_composite));
+	this->write_filter_primitive(e);
+	this->write_inputable(e);
+	this->write_second_inputable(e);
+	this->write_unsigned(unsigned(e.operator__));
+	this->write_real(e.k1);
+	this->write_real(e.k2);
+	this->write_real(e.k3);
+	this->write_real(e.k4);
+}
+
+void binary_writer::visit(const image_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::image));
+	this->write_element(e);
+	this->write_styleable(e);
+	this->write_transformable(e);
+	this->write_rectangle(e);
+	this->write_referencing(e);
+	this->write_aspect_ratioed(e);
+}
+
+void binary_writer::visit(const mask_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::mask));
+	this->write_element(e);
+	this->write_rectangle(e);
+	this->write_styleable(e);
+	this->write_unsigned(unsigned(e.mask_units));
+	this->write_unsigned(unsigned(e.mask_content_units));
+	this->write_children(e);
+}
+
+void binary_writer::visit(const text_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::text));
+	this->write_element(e);
+	this->write_styleable(e);
+	this->write_transformable(e);
+
+	// text_positioning has no attributes yet, when they are added the format version has to be increased
+	this->write_children(e);
+}
+
+void binary_writer::visit(const style_element& e){
+	this->write_kind(uint8_t(binary_format::element_kind::style));
+	this->write_element(e);
+
+	// cssom does not give access to the parsed selectors, so CSS is stored as text
+	this->write_string(e.css_to_string());
+}
+
+void binary_writer::default_visit(const element& e){
+	throw std::invalid_argument("binary_writer: element of unsupported type: " + e.get_tag());
+}
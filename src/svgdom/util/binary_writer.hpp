@@ -0,0 +1,123 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <ostream>
+#include <unordered_map>
+
+#include "../visitor.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Writer of binary document format.
+ * Writes document tree in compact binary format which can be read back with binary_reader.
+ * Unlike the XML, the binary format stores parsed values, like path steps, transformations
+ * and style values, so reading it does not involve any text parsing, except for the CSS
+ * of the 'style' elements.
+ *
+ * Usage:
+ * @code
+ * std::stringstream ss;
+ * svgdom::binary_writer w(ss);
+ * dom->accept(w);
+ * @endcode
+ *
+ * The format header is written by the constructor, so only one element tree is to be written
+ * with one binary_writer object.
+ * Elements of custom types are not supported, std::invalid_argument is thrown on those.
+ */
+class binary_writer : virtual public const_visitor{
+protected:
+	std::ostream& s;
+
+	// symbol numbers of the strings written so far
+	std::unordered_map<std::string, size_t> symbols;
+
+	void write_byte(uint8_t v);
+	void write_unsigned(uint64_t v);
+	void write_real(real v);
+	void write_string(std::string_view str);
+	void write_symbol(std::string_view str);
+	void write_length(const length& l);
+	void write_style_value(const style_value& v);
+
+	void write_kind(uint8_t kind);
+	void write_children(const container& c);
+
+	void write_element(const element& e);
+	void write_transformable(const transformable& e);
+	void write_styleable(const styleable& e);
+	void write_view_boxed(const view_boxed& e);
+	void write_aspect_ratioed(const aspect_ratioed& e);
+	void write_rectangle(const rectangle& e);
+	void write_shape(const shape& e);
+	void write_points(const polyline_shape& e);
+	void write_referencing(const referencing& e);
+	void write_gradient(const gradient& e);
+	void write_filter_primitive(const filter_primitive& e);
+	void write_inputable(const inputable& e);
+	void write_second_inputable(const second_inputable& e);
+
+public:
+	/**
+	 * @brief Constructor.
+	 * Writes the binary format header to the stream.
+	 * @param s - stream to write to.
+	 */
+	binary_writer(std::ostream& s);
+
+	void visit(const g_element& e) override;
+	void visit(const svg_element& e) override;
+	void visit(const symbol_element& e) override;
+	void visit(const defs_element& e) override;
+	void visit(const linear_gradient_element& e) override;
+	void visit(const radial_gradient_element& e) override;
+	void visit(const gradient::stop_element& e) override;
+	void visit(const use_element& e) override;
+	void visit(const path_element& e) override;
+	void visit(const circle_element& e) override;
+	void visit(const polyline_element& e) override;
+	void visit(const polygon_element& e) override;
+	void visit(const ellipse_element& e) override;
+	void visit(const rect_element& e) override;
+	void visit(const line_element& e) override;
+	void visit(const filter_element& e) override;
+	void visit(const fe_gaussian_blur_element& e) override;
+	void visit(const fe_color_matrix_element& e) override;
+	void visit(const fe_blend_element& e) override;
+	void visit(const fe_composite_element& e) override;
+	void visit(const image_element& e) override;
+	void visit(const mask_element& e) override;
+	void visit(const text_element& e) override;
+	void visit(const style_element& e) override;
+
+	void default_visit(const element& e) override;
+};
+
+}
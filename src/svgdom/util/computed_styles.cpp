@@ -0,0 +1,227 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "computed_styles.hpp"
+
+#include <array>
+
+#include "../visitor.hpp"
+#include "../elements/style.hpp"
+
+#include "casters.hpp"
+#include "style_stack.hpp"
+
+using namespace svgdom;
+
+namespace{
+class css_collector : public svgdom::const_visitor{
+public:
+	std::vector<std::reference_wrapper<const cssom::sheet>> sheets;
+
+	void visit(const svgdom::style_element& e)override{
+		this->sheets.push_back(e.css);
+	}
+};
+}
+
+namespace{
+// Values of a style property passed down from an element to its children.
+// Together they allow resolving the property value of the child the same way
+// style_stack::get_style_property() does when walking up the ancestors chain.
+struct inherited_value{
+	// first non-'inherit' value of style or presentation attribute up the ancestors chain
+	const style_value* value = nullptr;
+
+	// first non-'inherit' value of style up the ancestors chain
+	const style_value* style = nullptr;
+
+	// where walking up the ancestors chain while style value is 'inherit' stops
+	enum class stop{
+		end, // reached the root element
+		missing, // reached element without style value
+		value // reached element with non-'inherit' style value, stored in style_stop_value
+	} style_stop = stop::end;
+	const style_value* style_stop_value = nullptr;
+};
+
+typedef std::array<inherited_value, size_t(style_property::ENUM_SIZE)> inherited_values;
+
+class resolver : public svgdom::const_visitor{
+	style_stack ss;
+	bool no_css;
+
+	// ordinals of styleable ancestors, parallel to style stack
+	std::vector<size_t> styleable_ordinals;
+
+	// inherited values for each styleable ancestor, first one is for the root's parent
+	std::vector<inherited_values> inherited_stack;
+
+	void add_element(const svgdom::element& e){
+		this->ordinals.insert(std::make_pair(&e, this->elements.size()));
+		this->elements.push_back(&e);
+		this->values.resize(this->values.size() + size_t(style_property::ENUM_SIZE), nullptr);
+	}
+
+	void copy_parent_values(){
+		if(this->styleable_ordinals.empty()){
+			return;
+		}
+		auto src = this->values.begin() + this->styleable_ordinals.back() * size_t(style_property::ENUM_SIZE);
+		std::copy(
+				src,
+				src + size_t(style_property::ENUM_SIZE),
+				this->values.end() - size_t(style_property::ENUM_SIZE)
+			);
+	}
+
+	void resolve(const styleable& s){
+		this->inherited_stack.emplace_back();
+		const auto& parent = this->inherited_stack[this->inherited_stack.size() - 2];
+		auto& next = this->inherited_stack.back();
+
+		auto row = this->values.end() - size_t(style_property::ENUM_SIZE);
+
+		for(size_t i = 0; i != size_t(style_property::ENUM_SIZE); ++i){
+			auto p = style_property(i);
+			auto& pi = parent[i];
+			auto& ni = next[i];
+
+			auto sv = s.get_style_property(p);
+			auto av = s.get_presentation_attribute(p);
+
+			const style_value* v;
+			if(sv && !is_inherit(*sv)){
+				v = sv;
+			}else{
+				auto cv = this->no_css ? nullptr : this->ss.get_css_style_property(p);
+				if(sv){
+					// style is 'inherit'
+					if(!cv){
+						v = pi.value;
+					}else if(is_inherit(*cv)){
+						v = pi.style;
+					}else{
+						switch(pi.style_stop){
+							case inherited_value::stop::value:
+								v = pi.style_stop_value;
+								break;
+							case inherited_value::stop::missing:
+								v = cv;
+								break;
+							default:
+							case inherited_value::stop::end:
+								v = nullptr;
+								break;
+						}
+					}
+				}else if(cv){
+					v = is_inherit(*cv) ? pi.style : cv;
+				}else if(av){
+					v = is_inherit(*av) ? pi.value : av;
+				}else{
+					v = styleable::is_inherited(p) ? pi.value : nullptr;
+				}
+			}
+			row[i] = v;
+
+			auto sav = sv ? sv : av;
+			ni.value = sav && !is_inherit(*sav) ? sav : pi.value;
+
+			if(!sv){
+				ni.style = pi.style;
+				ni.style_stop = inherited_value::stop::missing;
+			}else if(is_inherit(*sv)){
+				ni.style = pi.style;
+				ni.style_stop = pi.style_stop;
+				ni.style_stop_value = pi.style_stop_value;
+			}else{
+				ni.style = sv;
+				ni.style_stop = inherited_value::stop::value;
+				ni.style_stop_value = sv;
+			}
+		}
+	}
+
+	void visit_element(const svgdom::element& e, const svgdom::container* c){
+		this->add_element(e);
+
+		auto s = cast_to_styleable(&e);
+		if(!s){
+			this->copy_parent_values();
+			if(c){
+				this->relay_accept(*c);
+			}
+			return;
+		}
+
+		style_stack::push push(this->ss, *s);
+		this->resolve(*s);
+
+		if(c){
+			this->styleable_ordinals.push_back(this->elements.size() - 1);
+			this->relay_accept(*c);
+			this->styleable_ordinals.pop_back();
+		}
+
+		this->inherited_stack.pop_back();
+	}
+
+public:
+	std::vector<const element*> elements;
+	std::unordered_map<const element*, size_t> ordinals;
+	std::vector<const style_value*> values;
+
+	resolver(utki::span<const std::reference_wrapper<const cssom::sheet>> sheets) :
+			no_css(sheets.empty()),
+			inherited_stack(1)
+	{
+		for(auto& s : sheets){
+			this->ss.add_css(s);
+		}
+	}
+
+	void default_visit(const svgdom::element& e)override{
+		this->visit_element(e, nullptr);
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		this->visit_element(e, &c);
+	}
+};
+}
+
+computed_styles::computed_styles(const svgdom::element& root){
+	css_collector cc;
+	root.accept(cc);
+
+	resolver r(utki::make_span(cc.sheets));
+	root.accept(r);
+
+	this->elements = std::move(r.elements);
+	this->ordinals = std::move(r.ordinals);
+	this->values = std::move(r.values);
+}
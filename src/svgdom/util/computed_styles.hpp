@@ -0,0 +1,134 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include <utki/span.hpp>
+#include <utki/debug.hpp>
+
+#include "../elements/element.hpp"
+#include "../elements/styleable.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Table of computed style property values.
+ * The constructor walks the element tree once and resolves values of all style properties
+ * for every element, propagating inherited values from parent to children. The result is
+ * stored in a contiguous table, one row of style_property::ENUM_SIZE values per element.
+ * Resolved values are the same as style_stack::get_style_property() would return with
+ * all elements from the root down to the element pushed to the stack and CSS sheets of all
+ * the 'style' elements of the tree added to it.
+ * For elements which are not styleable the values of the nearest styleable ancestor are stored.
+ *
+ * Elements are identified by ordinal, which is the index of the element in the pre-order
+ * traversal of the tree, the root element has ordinal of 0.
+ *
+ * The table holds pointers to the values stored in the document tree, so it is only valid
+ * as long as the document is not changed.
+ */
+class computed_styles{
+public:
+	computed_styles(const svgdom::element& root);
+
+	/**
+	 * @brief Get number of elements in the table.
+	 * @return number of elements.
+	 */
+	size_t size()const noexcept{
+		return this->elements.size();
+	}
+
+	/**
+	 * @brief Get element by ordinal.
+	 * @param ordinal - ordinal of the element.
+	 * @return element with given ordinal.
+	 */
+	const element& get_element(size_t ordinal)const noexcept{
+		ASSERT(ordinal < this->elements.size())
+		return *this->elements[ordinal];
+	}
+
+	/**
+	 * @brief Get ordinal of the element.
+	 * @param e - element to get the ordinal of.
+	 * @return ordinal of the element.
+	 * @throw std::out_of_range - if the element is not in the table.
+	 */
+	size_t get_ordinal(const element& e)const{
+		return this->ordinals.at(&e);
+	}
+
+	/**
+	 * @brief Get computed values of all style properties of the element.
+	 * @param ordinal - ordinal of the element.
+	 * @return span of style_property::ENUM_SIZE values, indexed by style_property.
+	 *         Values for properties which are not set are nullptr.
+	 */
+	utki::span<const style_value* const> get(size_t ordinal)const noexcept{
+		ASSERT(ordinal < this->elements.size())
+		return utki::make_span(
+				this->values.data() + ordinal * size_t(style_property::ENUM_SIZE),
+				size_t(style_property::ENUM_SIZE)
+			);
+	}
+
+	/**
+	 * @brief Get computed value of the style property.
+	 * @param ordinal - ordinal of the element.
+	 * @param p - style property to get.
+	 * @return pointer to the property value.
+	 * @return nullptr if the property is not set.
+	 */
+	const style_value* get(size_t ordinal, style_property p)const noexcept{
+		ASSERT(ordinal < this->elements.size())
+		ASSERT(p < style_property::ENUM_SIZE)
+		return this->values[ordinal * size_t(style_property::ENUM_SIZE) + size_t(p)];
+	}
+
+	/**
+	 * @brief Get computed value of the style property.
+	 * @param e - element to get the property value of.
+	 * @param p - style property to get.
+	 * @return pointer to the property value.
+	 * @return nullptr if the property is not set.
+	 * @throw std::out_of_range - if the element is not in the table.
+	 */
+	const style_value* get(const element& e, style_property p)const{
+		return this->get(this->get_ordinal(e), p);
+	}
+
+private:
+	std::vector<const element*> elements;
+	std::unordered_map<const element*, size_t> ordinals;
+	std::vector<const style_value*> values;
+};
+
+}
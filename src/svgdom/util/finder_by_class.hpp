@@ -40,7 +40,13 @@ namespace svgdom{
 class finder_by_class{
 public:
 
-	finder_by_class(const svgdom::element& root);
+	/**
+	 * @brief Constructor.
+	 * @param root - root element of the tree to search in.
+	 * @param num_threads - maximum number of threads to use for building the cache, see parallel_traversal.
+	 *                      0 means number of hardware threads.
+	 */
+	finder_by_class(const svgdom::element& root, unsigned num_threads = 1);
 
 	utki::span<const element* const> find(const std::string& cls)const noexcept;
 
@@ -27,39 +27,58 @@ SOFTWARE.
 
 #include "finder_by_id.hpp"
 
-#include <utki/debug.hpp>
-
-#include "../visitor.hpp"
+#include "traversal.hpp"
+#include "parallel_traversal.hpp"
 
 using namespace svgdom;
 
 namespace{
-class cache_creator : virtual public svgdom::const_visitor{
-private:
-	void add_to_cache(const svgdom::element& e){
+struct id_collector{
+	std::vector<std::pair<std::string_view, const element*>> ids;
+
+	void operator()(const element& e){
 		if(!e.id.empty()){
-			this->cache.insert(std::make_pair(e.id, &e));
+			this->ids.push_back(std::make_pair(std::string_view(e.id), &e));
 		}
 	}
-
-public:
-	std::unordered_map<std::string, const element*> cache;
-
-	void default_visit(const element& e){
-		this->add_to_cache(e);
-	}
 };
 }
 
-finder_by_id::finder_by_id(const svgdom::element& root) :
-	cache([&root](){
-		cache_creator cc;
+finder_by_id::finder_by_id(const svgdom::element& root, unsigned num_threads){
+	if(num_threads == 1){
+		traversal::pre_order(root, [this](const element& e){
+			if(!e.id.empty()){
+				// in case of duplicate ids the first element wins
+				this->cache.insert(std::make_pair(e.id, &e));
+			}
+		});
+		return;
+	}
+
+	std::vector<decltype(id_collector::ids)> parts;
+
+	parallel_traversal::pre_order(
+			root,
+			[](){return id_collector();},
+			[&parts](id_collector& c){
+				parts.push_back(std::move(c.ids));
+			},
+			num_threads
+		);
 
-		root.accept(cc);
+	size_t num_ids = 0;
+	for(const auto& p : parts){
+		num_ids += p.size();
+	}
+	this->cache.reserve(num_ids);
 
-		return std::move(cc.cache);
-	}())
-{}
+	// parts go in document order, so in case of duplicate ids the first element wins, as in one-threaded case
+	for(const auto& p : parts){
+		for(const auto& i : p){
+			this->cache.insert(std::make_pair(std::string(i.first), i.second));
+		}
+	}
+}
 
 const svgdom::element* finder_by_id::find(const std::string& id)const noexcept{
 	if(id.length() == 0){
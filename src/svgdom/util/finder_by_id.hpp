@@ -38,7 +38,13 @@ namespace svgdom{
 class finder_by_id{
 public:
 
-	finder_by_id(const svgdom::element& root);
+	/**
+	 * @brief Constructor.
+	 * @param root - root element of the tree to search in.
+	 * @param num_threads - maximum number of threads to use for building the cache, see parallel_traversal.
+	 *                      0 means number of hardware threads.
+	 */
+	finder_by_id(const svgdom::element& root, unsigned num_threads = 1);
 
 	const element* find(const std::string& id)const noexcept;
 
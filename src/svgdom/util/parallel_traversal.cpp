@@ -0,0 +1,129 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "parallel_traversal.hpp"
+
+#include <algorithm>
+
+#include "../parallel.hxx"
+
+using namespace svgdom;
+
+namespace{
+// limits the splitting of deeply nested trees
+const unsigned max_split_depth = 64;
+}
+
+std::vector<parallel_traversal::item> parallel_traversal::split(const element& root, size_t num_tasks){
+	std::vector<item> items = {item{&root, true}};
+
+	// expand the tree level by level, until there are enough subtrees to distribute among the tasks,
+	// the expanded elements are left in place as non-deep items, so the items remain in pre-order
+	for(unsigned depth = 0; depth != max_split_depth; ++depth){
+		size_t num_deep = 0;
+		for(const auto& i : items){
+			if(i.deep){
+				++num_deep;
+			}
+		}
+		if(num_deep >= num_tasks){
+			break;
+		}
+
+		std::vector<item> expanded;
+		bool changed = false;
+		for(const auto& i : items){
+			auto c = i.deep ? i.e->get_container() : nullptr;
+			if(!c || c->children.empty()){
+				expanded.push_back(i);
+				continue;
+			}
+			expanded.push_back(item{i.e, false});
+			for(const auto& child : c->children){
+				expanded.push_back(item{child.get(), true});
+			}
+			changed = true;
+		}
+
+		if(!changed){
+			break;
+		}
+
+		items = std::move(expanded);
+	}
+
+	return items;
+}
+
+std::vector<utki::span<const parallel_traversal::item>> parallel_traversal::make_tasks(utki::span<const item> items, size_t num_tasks){
+	size_t num_deep = 0;
+	for(const auto& i : items){
+		if(i.deep){
+			++num_deep;
+		}
+	}
+
+	// number of deep items per task, rounded up
+	size_t task_size = std::max((num_deep + num_tasks - 1) / num_tasks, size_t(1));
+
+	std::vector<utki::span<const item>> ret;
+
+	auto begin = items.begin();
+	size_t num_deep_in_task = 0;
+	for(auto i = items.begin(); i != items.end(); ++i){
+		if(!i->deep){
+			continue;
+		}
+		++num_deep_in_task;
+		if(num_deep_in_task == task_size){
+			ret.push_back(utki::make_span(&*begin, size_t(i + 1 - begin)));
+			begin = i + 1;
+			num_deep_in_task = 0;
+		}
+	}
+	if(begin != items.end()){
+		ret.push_back(utki::make_span(&*begin, size_t(items.end() - begin)));
+	}
+
+	return ret;
+}
+
+parallel_traversal::partition parallel_traversal::make_partition(const element& root, unsigned num_threads){
+	partition ret;
+	ret.num_threads = get_num_threads(num_threads);
+
+	size_t num_tasks = size_t(ret.num_threads) * tasks_per_thread;
+
+	ret.items = split(root, num_tasks);
+	ret.tasks = make_tasks(utki::make_span(ret.items), num_tasks);
+
+	return ret;
+}
+
+void parallel_traversal::run(const partition& p, const std::function<void(size_t)>& process_task){
+	run_tasks(p.tasks.size(), p.num_threads, process_task);
+}
@@ -0,0 +1,161 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <vector>
+#include <functional>
+
+#include <utki/span.hpp>
+
+#include "traversal.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Parallel traversal of element tree.
+ * Splits the element tree into parts and traverses the parts concurrently.
+ * The element tree must not be modified during the traversal.
+ */
+class parallel_traversal{
+public:
+	/**
+	 * @brief Part of the split element tree.
+	 */
+	struct item{
+		const element* e;
+
+		/**
+		 * @brief Whether the whole subtree of the element is a part.
+		 * If true, the whole subtree of the element is to be traversed, otherwise only the element itself,
+		 * its children are then given by the following items.
+		 */
+		bool deep;
+	};
+
+	/**
+	 * @brief Element tree split into tasks.
+	 * The partition is move-only, because the tasks refer to the items.
+	 */
+	struct partition{
+		/**
+		 * @brief Number of threads to run the tasks with.
+		 */
+		unsigned num_threads = 1;
+
+		/**
+		 * @brief Parts of the tree, in pre-order.
+		 * Each element of the tree is covered by exactly one item, either directly or as part of a deep item's subtree.
+		 */
+		std::vector<item> items;
+
+		/**
+		 * @brief Tasks to run.
+		 * Consecutive ranges of the items, in pre-order.
+		 */
+		std::vector<utki::span<const item>> tasks;
+
+		partition() = default;
+
+		partition(const partition&) = delete;
+		partition& operator=(const partition&) = delete;
+
+		partition(partition&&) = default;
+		partition& operator=(partition&&) = default;
+	};
+
+	/**
+	 * @brief Split element tree into tasks.
+	 * The tree is split into several tasks per thread, so that the threads get balanced load.
+	 * @param root - root element of the tree.
+	 * @param num_threads - maximum number of threads to use. 0 means number of hardware threads.
+	 * @return partition of the tree.
+	 */
+	static partition make_partition(const element& root, unsigned num_threads = 0);
+
+	/**
+	 * @brief Run the tasks of the partition concurrently.
+	 * The calling thread is also used for running the tasks.
+	 * If any of the tasks throws, then the exception is rethrown after all the threads have finished.
+	 * @param p - partition to run.
+	 * @param process_task - function which is called with index of each task of the partition.
+	 */
+	static void run(const partition& p, const std::function<void(size_t)>& process_task);
+
+private:
+	static std::vector<item> split(const element& root, size_t num_tasks);
+
+	static std::vector<utki::span<const item>> make_tasks(utki::span<const item> items, size_t num_tasks);
+
+public:
+	/**
+	 * @brief Traverse element tree in pre-order using several threads.
+	 * The tree is split into a number of parts, each part is traversed by its own worker.
+	 * A worker is a function object with signature void(const element&), it is called for each element of its part
+	 * in pre-order. Workers are created by the factory function on the calling thread, then the parts are traversed
+	 * concurrently and then the merge function is called for each worker on the calling thread.
+	 * Parts are made of elements going one after another in pre-order and merge function is called for the workers
+	 * in order of their parts, so merging the workers' results gives the same result as traversing the whole tree
+	 * with one worker, regardless of the number of threads.
+	 * If any of the workers throws, then the exception is rethrown after all the threads have finished.
+	 * @param root - root element of the tree.
+	 * @param make_worker - worker factory function.
+	 * @param merge - merge function with signature void(worker_type&).
+	 * @param num_threads - maximum number of threads to use. 0 means number of hardware threads.
+	 *                      The calling thread is also used for traversing.
+	 */
+	template <class factory_type, class merge_type>
+	static void pre_order(const element& root, factory_type&& make_worker, merge_type&& merge, unsigned num_threads = 0){
+		auto p = make_partition(root, num_threads);
+
+		std::vector<decltype(make_worker())> workers;
+		workers.reserve(p.tasks.size());
+		for(size_t i = 0; i != p.tasks.size(); ++i){
+			workers.push_back(make_worker());
+		}
+
+		run(
+				p,
+				[&p, &workers](size_t i){
+					auto& w = workers[i];
+					for(const auto& it : p.tasks[i]){
+						if(it.deep){
+							traversal::pre_order(*it.e, w);
+						}else{
+							w(*it.e);
+						}
+					}
+				}
+			);
+
+		for(auto& w : workers){
+			merge(w);
+		}
+	}
+};
+
+}
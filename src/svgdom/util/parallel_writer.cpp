@@ -0,0 +1,158 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "parallel_writer.hpp"
+
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "parallel_traversal.hpp"
+#include "stream_writer.hpp"
+
+#include "../parallel.hxx"
+
+using namespace svgdom;
+
+namespace{
+// writes subtree which is a part of the bigger tree, so it starts at the given indentation
+class subtree_writer : public stream_writer{
+public:
+	subtree_writer(std::ostream& s, const write_options& options, unsigned indent) :
+			stream_writer(s, options)
+	{
+		this->indent = indent;
+	}
+};
+
+// writes the tree, but instead of subtrees which are already formatted writes their text
+class assembling_writer : public stream_writer{
+	const std::unordered_map<const element*, std::string>& subtrees;
+
+	bool write_subtree(const element& e){
+		auto i = this->subtrees.find(&e);
+		if(i == this->subtrees.end()){
+			return false;
+		}
+		this->s.write(i->second.data(), i->second.size());
+		return true;
+	}
+protected:
+	void write_child(const element& e)override{
+		if(!this->write_subtree(e)){
+			this->stream_writer::write_child(e);
+		}
+	}
+public:
+	assembling_writer(std::ostream& s, const write_options& options, const std::unordered_map<const element*, std::string>& subtrees) :
+			stream_writer(s, options),
+			subtrees(subtrees)
+	{}
+
+	void write_root(const element& root){
+		if(!this->write_subtree(root)){
+			root.accept(*this);
+		}
+	}
+};
+}
+
+void parallel_writer::write(std::ostream& s, const element& root, const write_options& options, unsigned num_threads){
+	num_threads = get_num_threads(num_threads);
+
+	if(num_threads == 1){
+		stream_writer w(s, options);
+		root.accept(w);
+		return;
+	}
+
+	auto p = parallel_traversal::make_partition(root, num_threads);
+
+	// subtrees are formatted with indentation of their depth in the tree,
+	// only the expanded elements, i.e. not deep items, can have subtrees as children
+	std::unordered_set<const element*> expanded;
+	for(const auto& i : p.items){
+		if(!i.deep){
+			expanded.insert(i.e);
+		}
+	}
+
+	std::unordered_map<const element*, unsigned> depths;
+	{
+		std::vector<std::pair<const element*, unsigned>> stack = {{&root, 0}};
+		while(!stack.empty()){
+			auto e = stack.back();
+			stack.pop_back();
+
+			if(expanded.find(e.first) == expanded.end()){
+				depths[e.first] = e.second;
+				continue;
+			}
+
+			auto c = e.first->get_container();
+			ASSERT(c)
+			for(const auto& child : c->children){
+				stack.emplace_back(child.get(), e.second + 1);
+			}
+		}
+	}
+
+	// create all the buffers before starting the threads, so that the map is not modified concurrently
+	std::unordered_map<const element*, std::string> subtrees;
+	subtrees.reserve(depths.size());
+	for(const auto& d : depths){
+		subtrees[d.first];
+	}
+
+	parallel_traversal::run(
+			p,
+			[&](size_t i){
+				std::ostringstream ss;
+				for(const auto& it : p.tasks[i]){
+					if(!it.deep){
+						continue;
+					}
+
+					ss.str(std::string());
+
+					subtree_writer w(ss, options, depths.at(it.e));
+					it.e->accept(w);
+
+					subtrees.at(it.e) = ss.str();
+				}
+			}
+		);
+
+	assembling_writer w(s, options, subtrees);
+	w.write_root(root);
+}
+
+std::string parallel_writer::to_string(const element& root, const write_options& options, unsigned num_threads){
+	std::stringstream s;
+	write(s, root, options, num_threads);
+	return s.str();
+}
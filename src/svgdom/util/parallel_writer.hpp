@@ -0,0 +1,69 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "../elements/element.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Writer which formats parts of the document concurrently.
+ * The element tree is split into subtrees the same way as parallel_traversal does it,
+ * the subtrees are formatted into separate buffers concurrently and then the buffers
+ * are written in document order. The output is exactly the same as of element::to_string().
+ * The element tree must not be modified during writing.
+ */
+class parallel_writer{
+public:
+	/**
+	 * @brief Write element tree to stream.
+	 * If any of the subtrees fails to be written, then the exception is rethrown after all the threads have finished,
+	 * nothing is written to the stream in this case.
+	 * @param s - stream to write to.
+	 * @param root - root element of the tree to write.
+	 * @param options - writing options.
+	 * @param num_threads - maximum number of threads to use. 0 means number of hardware threads.
+	 *                      The calling thread is also used for writing.
+	 */
+	static void write(std::ostream& s, const element& root, const write_options& options = write_options(), unsigned num_threads = 0);
+
+	/**
+	 * @brief Convert element tree to string.
+	 * Same as element::to_string(), but using several threads.
+	 * @param root - root element of the tree to convert.
+	 * @param options - writing options.
+	 * @param num_threads - maximum number of threads to use. 0 means number of hardware threads.
+	 * @return SVG text of the element tree.
+	 */
+	static std::string to_string(const element& root, const write_options& options = write_options(), unsigned num_threads = 0);
+};
+
+}
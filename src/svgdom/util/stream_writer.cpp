@@ -27,11 +27,11 @@ SOFTWARE.
 
 #include "stream_writer.hpp"
 
+#include <stdexcept>
+
 #include <utki/util.hpp>
 #include <utki/string.hpp>
 
-#include <papki/vector_file.hpp>
-
 #include "../util.hxx"
 
 using namespace svgdom;
@@ -41,56 +41,101 @@ void stream_writer::set_name(const std::string& name){
 }
 
 void stream_writer::add_attribute(std::string_view name, const std::string& value){
-	this->attributes.push_back(std::make_pair(std::string(name), value));
+	this->attributes += ' ';
+	this->attributes += name;
+	this->attributes += "=\"";
+	this->attributes += value;
+	this->attributes += '"';
 }
 
 void stream_writer::add_attribute(std::string_view name, const length& value){
-	std::stringstream ss;
-	ss << value;
-	this->add_attribute(name, ss.str());
+	this->attributes += ' ';
+	this->attributes += name;
+	this->attributes += "=\"";
+	append_length(this->attributes, value, this->options.precision);
+	this->attributes += '"';
 }
 
 void stream_writer::add_attribute(std::string_view name, real value){
-	std::stringstream ss;
-	ss << value;
-	this->add_attribute(name, ss.str());
+	this->attributes += ' ';
+	this->attributes += name;
+	this->attributes += "=\"";
+	append_number(this->attributes, value, this->options.precision);
+	this->attributes += '"';
 }
 
 void stream_writer::write(const container* children, const std::string& content){
-	auto ind = this->indent_str();
-
 	auto tag = std::move(this->name);
-	
-	this->s << ind << "<" << tag;
-	
-	for(auto& a : this->attributes){
-		this->s << " " << a.first << "=\"" << a.second << "\"";
+	this->name.clear();
+
+	// the whole opening tag is formatted in the buffer and written to the stream at once
+	auto& buf = this->tag_buffer;
+	buf.clear();
+	if(!this->options.compact){
+		buf.append(this->indent, '\t');
 	}
+	buf += '<';
+	buf += tag;
+	buf += this->attributes;
 
 	this->attributes.clear();
-	this->name.clear();
 	
 	if((!children || children->children.size() == 0) && content.empty()){
-		this->s << "/>";
-	}else{
-		this->s << ">" << std::endl;
-		if(children){
-			this->children_to_stream(*children);
+		buf += "/>";
+		if(!this->options.compact){
+			buf += '\n';
 		}
-		this->s << content;
-		this->s << ind << "</" << tag << ">";
+		this->s.write(buf.data(), buf.size());
+		this->flush_if_outermost();
+		return;
+	}
+
+	buf += '>';
+	if(!this->options.compact){
+		buf += '\n';
+	}
+	this->s.write(buf.data(), buf.size());
+
+	if(children){
+		this->children_to_stream(*children);
 	}
-	this->s << std::endl;
+	this->s << content;
+
+	// the buffer could be used by children
+	buf.clear();
+	if(!this->options.compact){
+		buf.append(this->indent, '\t');
+	}
+	buf += "</";
+	buf += tag;
+	buf += '>';
+	if(!this->options.compact){
+		buf += '\n';
+	}
+	this->s.write(buf.data(), buf.size());
+	this->flush_if_outermost();
 }
 
-std::string stream_writer::indent_str(){
-	std::string ind;
+const write_options& stream_writer::check(const write_options& options){
+	if(options.precision == 0){
+		throw std::invalid_argument("stream_writer: write_options::precision must be at least 1");
+	}
+	return options;
+}
 
-	std::stringstream ss;
-	for(unsigned i = 0; i != this->indent; ++i){
-		ss << "\t";
+void stream_writer::flush_if_outermost(){
+	// the stream is flushed once the outermost element is written, not after each element,
+	// flushing after each element slows down writing to files a lot
+	if(this->indent == 0){
+		this->s.flush();
 	}
-	return ss.str();
+}
+
+std::string stream_writer::indent_str(){
+	if(this->options.compact){
+		return std::string();
+	}
+	return std::string(this->indent, '\t');
 }
 
 void stream_writer::children_to_stream(const container& e){
@@ -99,10 +144,14 @@ void stream_writer::children_to_stream(const container& e){
 		--this->indent;
 	});
 	for (auto& c : e.children){
-		c->accept(*this);
+		this->write_child(*c);
 	}
 }
 
+void stream_writer::write_child(const element& e){
+	e.accept(*this);
+}
+
 void stream_writer::add_element_attributes(const element& e){
 	if(e.id.length() != 0){
 		this->add_attribute("id", e.id);
@@ -111,20 +160,90 @@ void stream_writer::add_element_attributes(const element& e){
 
 void stream_writer::add_transformable_attributes(const transformable& e){
 	if(e.transformations.size() != 0){
-		this->add_attribute("transform", e.transformations_to_string());
+		this->add_attribute("transform", e.transformations_to_string(this->options.precision));
+	}
+}
+
+namespace{
+// Checks if the presentation attribute does not affect rendering and can be omitted.
+bool is_redundant_presentation_attribute(const style_map& styles, style_property p, const style_value& v){
+	// inline style always overrides presentation attribute
+	if(styles.find(p) != styles.end()){
+		return true;
+	}
+
+	// Inherited property value cannot be omitted as the parent element's value would be used instead.
+	// Non-inherited property without the attribute gets its initial value, unless set by CSS,
+	// but CSS overrides presentation attributes anyway.
+	if(styleable::is_inherited(p)){
+		return false;
+	}
+
+	switch(p){
+		case style_property::opacity:
+		case style_property::stop_opacity:
+		case style_property::flood_opacity:
+			return std::holds_alternative<real>(v) && *std::get_if<real>(&v) == 1;
+		case style_property::stop_color:
+			return std::holds_alternative<uint32_t>(v) && *std::get_if<uint32_t>(&v) == 0; // black
+		case style_property::display:
+			return std::holds_alternative<display>(v) && *std::get_if<display>(&v) == display::inline_;
+		case style_property::enable_background:
+			return std::holds_alternative<enable_background_property>(v)
+					&& std::get_if<enable_background_property>(&v)->value == enable_background::accumulate;
+		case style_property::clip_path:
+		case style_property::mask:
+		case style_property::filter:
+			return is_none(v);
+		default:
+			return false;
 	}
 }
+}
+
+namespace{
+// same as styleable::styles_to_string(), but without spaces after separators
+std::string styles_to_compact_string(const style_map& styles, unsigned precision){
+	std::string s;
+	for(auto& st : styles){
+		if(!s.empty()){
+			s += ';';
+		}
+		s += styleable::property_to_string(st.first);
+		s += ':';
+		s += styleable::style_value_to_string(st.first, st.second, precision);
+	}
+	return s;
+}
+}
 
 void stream_writer::add_styleable_attributes(const styleable& e){
-	if(!e.styles.empty()){
-		this->add_attribute("style", e.styles_to_string());
+	// the element is not modified, so deferred attributes are parsed into local copies
+	style_map deferred_styles;
+	style_map deferred_attributes;
+	if(e.deferred){
+		deferred_styles = e.parse_deferred_styles();
+		deferred_attributes = e.parse_deferred_presentation_attributes();
+	}
+	const auto& styles = e.deferred ? deferred_styles : e.styles;
+	const auto& attributes = e.deferred ? deferred_attributes : e.presentation_attributes;
+
+	if(!styles.empty()){
+		if(this->options.compact){
+			this->add_attribute("style", styles_to_compact_string(styles, this->options.precision));
+		}else{
+			this->add_attribute("style", styleable::styles_to_string(styles, this->options.precision));
+		}
 	}
-	for(auto& s : e.presentation_attributes){
+	for(auto& s : attributes){
 		auto n = styleable::property_to_string(s.first);
 		if(n.empty()){ // unknown property
 			continue;
 		}
-		this->add_attribute(n, styleable::style_value_to_string(s.first, s.second));
+		if(this->options.compact && is_redundant_presentation_attribute(styles, s.first, s.second)){
+			continue;
+		}
+		this->add_attribute(n, styleable::style_value_to_string(s.first, s.second, this->options.precision));
 	}
 	if(!e.classes.empty()){
 		this->add_attribute("class", e.classes_to_string());
@@ -133,7 +252,7 @@ void stream_writer::add_styleable_attributes(const styleable& e){
 
 void stream_writer::add_view_boxed_attributes(const view_boxed& e){
 	if(e.is_view_box_specified()){
-		this->add_attribute("viewBox", e.view_box_to_string());
+		this->add_attribute("viewBox", e.view_box_to_string(this->options.precision));
 	}
 }
 
@@ -181,7 +300,7 @@ void stream_writer::add_gradient_attributes(const gradient& e){
 	}
 	
 	if(e.transformations.size() != 0){
-		this->add_attribute("gradientTransform", e.transformations_to_string());
+		this->add_attribute("gradientTransform", e.transformations_to_string(this->options.precision));
 	}
 }
 
@@ -217,6 +336,36 @@ void stream_writer::add_shape_attributes(const shape& e){
 	this->add_styleable_attributes(e);
 }
 
+void stream_writer::add_points_attribute(const polyline_shape& e){
+	if(e.deferred){
+		// the element is not modified, so deferred points are parsed into a local copy
+		polyline_element parsed;
+		parsed.points = e.parse_deferred_points();
+		this->add_points_attribute(parsed);
+		return;
+	}
+	if(e.points.size() != 0){
+		this->add_attribute("points", e.points_to_string(this->options.precision));
+	}
+}
+
+void stream_writer::add_path_attribute(const path_element& e){
+	if(e.deferred){
+		// the element is not modified, so deferred path data is parsed into a local copy
+		path_element parsed;
+		parsed.path = e.parse_deferred_path();
+		this->add_path_attribute(parsed);
+		return;
+	}
+	if(e.path.size() != 0){
+		if(this->options.compact){
+			this->add_attribute("d", e.path_to_compact_string(this->options.precision));
+		}else{
+			this->add_attribute("d", e.path_to_string(this->options.precision));
+		}
+	}
+}
+
 void stream_writer::visit(const g_element& e){
 	this->set_name(e.get_tag());
 	this->add_element_attributes(e);
@@ -327,18 +476,14 @@ void stream_writer::visit(const ellipse_element& e){
 void stream_writer::visit(const polygon_element& e){
 	this->set_name(e.get_tag());
 	this->add_shape_attributes(e);
-	if(e.points.size() != 0){
-		this->add_attribute("points", e.points_to_string());
-	}
+	this->add_points_attribute(e);
 	this->write();
 }
 
 void stream_writer::visit(const polyline_element& e){
 	this->set_name(e.get_tag());
 	this->add_shape_attributes(e);
-	if(e.points.size() != 0){
-		this->add_attribute("points", e.points_to_string());
-	}
+	this->add_points_attribute(e);
 	this->write();
 }
 
@@ -363,9 +508,7 @@ void stream_writer::visit(const circle_element& e){
 void stream_writer::visit(const path_element& e){
 	this->set_name(e.get_tag());
 	this->add_shape_attributes(e);
-	if(e.path.size() != 0){
-		this->add_attribute("d", e.path_to_string());
-	}
+	this->add_path_attribute(e);
 	this->write();
 }
 
@@ -466,28 +609,15 @@ void stream_writer::visit(const style_element& e){
 	auto ind = this->indent_str();
 	--this->indent;
 
-	papki::vector_file fi;
-	e.css.write(
-			fi,
-			[](uint32_t id) -> std::string{
-				return std::string(styleable::property_to_string(style_property(id)));
-			},
-			[](uint32_t id, const cssom::property_value_base& value) -> std::string{
-				return styleable::style_value_to_string(
-						style_property(id),
-						static_cast<const style_element::css_style_value&>(value).value
-					);
-			},
-			ind
-		);
+	auto css_str = e.css_to_string(ind);
 
-	auto css_vec = fi.reset_data();
+	auto line_end = this->options.compact ? "" : "\n";
 
 	std::stringstream ss;
-	if(!css_vec.empty()){
-		ss << ind << cdata_open << std::endl;
-		ss << utki::make_string(css_vec);
-		ss << ind << cdata_close << std::endl;
+	if(!css_str.empty()){
+		ss << ind << cdata_open << line_end;
+		ss << css_str;
+		ss << ind << cdata_close << line_end;
 	}
 
 	this->write(nullptr, ss.str());
@@ -547,7 +677,7 @@ void stream_writer::visit(const fe_gaussian_blur_element& e){
 	this->add_inputable_attributes(e);
 	
 	if(e.is_std_deviation_specified()){
-		this->add_attribute("stdDeviation", number_and_optional_number_to_string(e.std_deviation, -1));
+		this->add_attribute("stdDeviation", number_and_optional_number_to_string(e.std_deviation, -1, this->options.precision));
 	}
 	this->write();
 }
@@ -31,17 +31,31 @@ SOFTWARE.
 
 namespace svgdom{
 
+/**
+ * @brief Visitor which writes elements to the stream as SVG.
+ * The stream is flushed when the element the writer is accepted by, i.e. the element at zero indentation,
+ * is written completely. The stream is not flushed after each of its descendants.
+ */
 class stream_writer : virtual public const_visitor{
 private:
 	void children_to_stream(const container& e);
+
+	void flush_if_outermost();
 	
 	std::string name;
-	std::vector<std::pair<std::string, std::string>> attributes;
+
+	// attributes of the element being written, already formatted as ' name="value"' pairs
+	std::string attributes;
+
+	// buffer for formatting the tag before writing it to the stream, kept to reuse its memory
+	std::string tag_buffer;
 protected:
 	// s, indent, and indent_str() are made protected to allow writing arbitrary content to stream for those who extend the class, as this was needed in some projects.
 	std::ostream& s;
 	unsigned indent = 0;
 	std::string indent_str();
+
+	const write_options options;
 	
 	void set_name(const std::string& name);
 	void add_attribute(std::string_view name, const std::string& value);
@@ -64,15 +78,36 @@ protected:
 				)
 		);
 	void add_shape_attributes(const shape& e);
+	void add_points_attribute(const polyline_shape& e);
+	void add_path_attribute(const path_element& e);
 	void add_referencing_attributes(const referencing& e);
 	void add_gradient_attributes(const gradient& e);
 	void add_filter_primitive_attributes(const filter_primitive& e);
 	void add_inputable_attributes(const inputable& e);
 	void add_second_inputable_attributes(const second_inputable& e);
 	void add_text_positioning_attributes(const text_positioning& e);
+
+	/**
+	 * @brief Write child element.
+	 * Called for each child of the element being written, the indentation is already increased at this point.
+	 * By default, the child is visited by this writer. Can be overridden to write the child some other way.
+	 * @param e - child element to write.
+	 */
+	virtual void write_child(const element& e);
 	
+private:
+	static const write_options& check(const write_options& options);
 public:
-	stream_writer(std::ostream& s) : s(s) {}
+	/**
+	 * @brief Constructor.
+	 * @param s - stream to write to.
+	 * @param options - writing options.
+	 * @throw std::invalid_argument - if options.precision is 0.
+	 */
+	stream_writer(std::ostream& s, const write_options& options = write_options()) :
+			s(s),
+			options(check(options))
+	{}
 	
 	void visit(const g_element& e) override;
 	void visit(const svg_element& e) override;
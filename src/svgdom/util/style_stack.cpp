@@ -99,17 +99,32 @@ style_stack::push::push(style_stack& ss, const svgdom::styleable& s) :
 		ss(ss)
 {
 	this->ss.stack.push_back(s);
+	this->ss.invalidate_css_cache();
 }
 
 style_stack::push::~push()noexcept{
 	this->ss.stack.pop_back();
+	this->ss.invalidate_css_cache();
 }
 
 void style_stack::add_css(const cssom::sheet& css_doc){
 	this->css.push_back(css_doc);
+	this->invalidate_css_cache();
 }
 
 const style_value* style_stack::get_css_style_property(style_property p)const{
+	if(this->css.empty()){
+		return nullptr;
+	}
+
+	auto& cache = this->css_cache;
+
+	ASSERT(p < style_property::ENUM_SIZE)
+	auto bit = uint64_t(1) << size_t(p);
+	if(cache.mask & bit){
+		return cache.values[size_t(p)];
+	}
+
 	crawler c(this->stack);
 	unsigned specificity = 0;
 	const style_value* ret = nullptr;
@@ -124,5 +139,9 @@ const style_value* style_stack::get_css_style_property(style_property p)const{
 		specificity = r.specificity;
 		ret = &static_cast<const style_element::css_style_value*>(r.value)->value;
 	}
+
+	cache.values[size_t(p)] = ret;
+	cache.mask |= bit;
+
 	return ret;
 }
@@ -28,6 +28,7 @@ SOFTWARE.
 #pragma once
 
 #include <vector>
+#include <array>
 
 #include <cssom/om.hpp>
 
@@ -35,8 +36,21 @@ SOFTWARE.
 #include "../elements/container.hpp"
 
 namespace svgdom{
+
+/**
+ * @brief Stack of styleable elements for resolving style property values.
+ * CSS property values of the top element are memoized, so the const methods modify the object.
+ * Because of that, the same style_stack object must not be used by several threads at a time,
+ * even via const methods. Use a copy of the style_stack per thread instead.
+ */
 class style_stack{
 public:
+	/**
+	 * @brief Styleable elements, from the root to the top of the stack.
+	 * The memoized CSS property values are reset by push and add_css(). If the stack is changed directly,
+	 * the memoized values of the former top element are still returned by get_css_style_property()
+	 * and get_style_property(), so the stack is to be filled before the first query.
+	 */
 	std::vector<std::reference_wrapper<const styleable>> stack;
 
 private:
@@ -57,9 +71,30 @@ private:
 		void reset()override;
 	};
 
-	const svgdom::style_value* get_css_style_property(svgdom::style_property p)const;
+	// CSS property values memoized for the top element of the stack
+	mutable struct{
+		// bit number N is set if value of the property N is memoized
+		uint64_t mask = 0;
+
+		std::array<const svgdom::style_value*, size_t(style_property::ENUM_SIZE)> values;
+	} css_cache;
+
+	void invalidate_css_cache()noexcept{
+		this->css_cache.mask = 0;
+	}
+
 public:
 	const svgdom::style_value* get_style_property(svgdom::style_property p)const;
+
+	/**
+	 * @brief Get style property value set by CSS for the top element of the stack.
+	 * Results of matching the top element against the CSS sheets are memoized per property until
+	 * the stack is changed by push or another CSS sheet is added.
+	 * @param p - style property to get.
+	 * @return pointer to the property value from the CSS rule with highest specificity.
+	 * @return nullptr if none of the added CSS sheets sets the property for the top element.
+	 */
+	const svgdom::style_value* get_css_style_property(svgdom::style_property p)const;
 	
 	void add_css(const cssom::sheet& css_doc);
 
@@ -27,6 +27,8 @@ SOFTWARE.
 
 #include "style_stack_cache.hpp"
 
+#include <algorithm>
+
 #include <utki/debug.hpp>
 
 #include "../visitor.hpp"
@@ -38,23 +40,38 @@ class cache_creator : virtual public svgdom::const_visitor{
 private:
 	void add_to_cache(const svgdom::element& e){
 		if(!e.id.empty()){
-			this->cache.insert(std::make_pair(e.id, this->current_style_stack));
+			this->cache.insert(std::make_pair(e.id, this->current_node));
 		}
 	}
 
-	style_stack current_style_stack;
+	const style_stack_cache::node* current_node = nullptr;
+
+	std::deque<style_stack_cache::node>& nodes;
+	std::unordered_map<std::string, const style_stack_cache::node*>& cache;
 
 public:
-	std::unordered_map<std::string, style_stack> cache;
-	
+	cache_creator(
+			std::deque<style_stack_cache::node>& nodes,
+			std::unordered_map<std::string, const style_stack_cache::node*>& cache
+		) :
+			nodes(nodes),
+			cache(cache)
+	{}
+
 	void visit_container(const svgdom::element& e, const svgdom::container& c, const svgdom::styleable& s){
-		style_stack::push push(this->current_style_stack, s);
+		auto parent = this->current_node;
+		this->nodes.emplace_back(s, parent);
+		this->current_node = &this->nodes.back();
 		this->add_to_cache(e);
 		this->relay_accept(c);
+		this->current_node = parent;
 	}
 	void visit_element(const svgdom::element& e, const svgdom::styleable& s){
-		style_stack::push push(this->current_style_stack, s);
-		this->add_to_cache(e);
+		if(e.id.empty()){
+			return;
+		}
+		this->nodes.emplace_back(s, this->current_node);
+		this->cache.insert(std::make_pair(e.id, &this->nodes.back()));
 	}
 	
 	void default_visit(const svgdom::element& e)override{
@@ -119,25 +136,56 @@ public:
 };
 }
 
-style_stack_cache::style_stack_cache(const svgdom::element& root) :
-	cache([&root](){
-		cache_creator cc;
+style_stack_cache::style_stack_cache(const svgdom::element& root){
+	cache_creator cc(this->nodes, this->cache);
 
-		root.accept(cc);
+	root.accept(cc);
+}
 
-		return std::move(cc.cache);
-	}())
-{}
+style_stack style_stack_cache::node::make_style_stack()const{
+	style_stack ret;
+
+	ret.stack.reserve(this->depth);
+	for(auto n = this; n; n = n->parent){
+		ret.stack.push_back(n->value);
+	}
+	std::reverse(ret.stack.begin(), ret.stack.end());
+
+	return ret;
+}
 
 const style_stack* style_stack_cache::find(const std::string& id)const noexcept{
 	if(id.length() == 0){
 		return nullptr;
 	}
 	
+	auto i = this->cache.find(id);
+	if(i == this->cache.end()){
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(this->stacks_mutex);
+
+	auto j = this->stacks.find(i->second);
+	if(j == this->stacks.end()){
+		j = this->stacks.insert(std::make_pair(
+				i->second,
+				i->second ? i->second->make_style_stack() : style_stack()
+			)).first;
+	}
+	
+	return &j->second;
+}
+
+const style_stack_cache::node* style_stack_cache::find_node(const std::string& id)const noexcept{
+	if(id.length() == 0){
+		return nullptr;
+	}
+	
 	auto i = this->cache.find(id);
 	if(i == this->cache.end()){
 		return nullptr;
 	}
 	
-	return &i->second;
+	return i->second;
 }
@@ -28,6 +28,8 @@ SOFTWARE.
 #pragma once
 
 #include <unordered_map>
+#include <deque>
+#include <mutex>
 
 #include "../elements/element.hpp"
 
@@ -37,11 +39,65 @@ namespace svgdom{
 
 class style_stack_cache{
 public:
+	/**
+	 * @brief Cached style stack.
+	 * Style stacks of all cached elements form a tree, each node of which holds
+	 * one styleable element and links to the node of its nearest styleable ancestor.
+	 * So, the node represents the style stack made of the elements from root node down to this node.
+	 */
+	struct node{
+		/**
+		 * @brief Styleable element at the top of the style stack.
+		 */
+		const svgdom::styleable& value;
+
+		/**
+		 * @brief Parent node.
+		 * Parent node is nullptr for the root node.
+		 */
+		const node* const parent;
+
+		/**
+		 * @brief Number of elements in the style stack.
+		 */
+		const size_t depth;
+
+		node(const svgdom::styleable& value, const node* parent) :
+				value(value),
+				parent(parent),
+				depth(parent ? parent->depth + 1 : 1)
+		{}
+
+		/**
+		 * @brief Create style stack.
+		 * @return style stack with the elements from root node down to this node.
+		 */
+		style_stack make_style_stack()const;
+	};
 
 	style_stack_cache(const svgdom::element& root);
 
+	/**
+	 * @brief Find style stack of the element by id.
+	 * The style stack is made from the cached nodes on first request and is kept in the cache,
+	 * so the returned pointer remains valid for the lifetime of the style_stack_cache object.
+	 * The same style stack object is returned to all callers, and style_stack is not safe to query
+	 * from several threads at a time, so threads are to query their own copies of it.
+	 * @param id - id of the element.
+	 * @return style stack which was current when the element was visited.
+	 * @return nullptr if element with given id is not found.
+	 */
 	const style_stack* find(const std::string& id)const noexcept;
 
+	/**
+	 * @brief Find top node of style stack of the element by id.
+	 * Unlike find(), does not make the style stack.
+	 * @param id - id of the element.
+	 * @return top node of the style stack which was current when the element was visited.
+	 * @return nullptr if element with given id is not found or the style stack is empty.
+	 */
+	const node* find_node(const std::string& id)const noexcept;
+
 	/**
 	 * @brief Get style-stack-by-id cache size.
 	 * @return number of cached elements.
@@ -51,7 +107,15 @@ public:
 	}
 
 private:
-	std::unordered_map<std::string, style_stack> cache;
+	// nodes are never removed, deque does not move nodes when growing, so it is safe to
+	// point to them
+	std::deque<node> nodes;
+
+	std::unordered_map<std::string, const node*> cache;
+
+	// style stacks made by find(), by top node
+	mutable std::mutex stacks_mutex;
+	mutable std::unordered_map<const node*, style_stack> stacks;
 };
 
 }
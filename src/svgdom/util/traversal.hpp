@@ -0,0 +1,134 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2021 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <vector>
+#include <type_traits>
+
+#include "../elements/element.hpp"
+#include "../elements/container.hpp"
+
+namespace svgdom{
+
+/**
+ * @brief Explicit-stack traversal of element tree.
+ * Unlike visitor, the traversal keeps the stack of visited containers in heap memory, so it is not limited
+ * by the call stack size and element trees of any depth can be traversed. It does not dispatch on element type,
+ * the children are found with element::get_container(), so it is meant for operations which do not depend
+ * on element type, like searching elements by id or by class. Use visitor for type dependent operations.
+ *
+ * The element tree must not be modified during the traversal.
+ */
+class traversal{
+	struct stack_item{
+		const element& e;
+		const container& c;
+		container::children_type::const_iterator i;
+	};
+
+	template <bool is_post_order, class function_type> static void traverse(const element& root, function_type&& func){
+		auto visit = [&func](const element& e) -> bool {
+			if constexpr (std::is_same<decltype(func(e)), bool>::value){
+				return func(e);
+			}else{
+				func(e);
+				return true;
+			}
+		};
+
+		if constexpr (!is_post_order){
+			if(!visit(root)){
+				return;
+			}
+		}
+
+		std::vector<stack_item> stack;
+
+		if(auto c = root.get_container()){
+			stack.push_back(stack_item{root, *c, c->children.begin()});
+		}else{
+			if constexpr (is_post_order){
+				visit(root);
+			}
+			return;
+		}
+
+		while(!stack.empty()){
+			auto& top = stack.back();
+
+			if(top.i == top.c.children.end()){
+				if constexpr (is_post_order){
+					visit(top.e);
+				}
+				stack.pop_back();
+				continue;
+			}
+
+			const element& e = **top.i;
+			++top.i;
+
+			if constexpr (!is_post_order){
+				if(!visit(e)){
+					continue;
+				}
+			}
+
+			if(auto c = e.get_container()){
+				// NOTE: 'top' reference is invalidated by push_back()
+				stack.push_back(stack_item{e, *c, c->children.begin()});
+			}else if constexpr (is_post_order){
+				visit(e);
+			}
+		}
+	}
+
+public:
+	/**
+	 * @brief Traverse element tree in pre-order.
+	 * Calls the function for each element of the tree, the parent elements before their children.
+	 * If the function returns bool, then returning false skips the children of the element,
+	 * this way the traversal can be limited to certain subtrees.
+	 * @param root - root element of the tree.
+	 * @param func - function to call for each element. Signature is void(const element&) or bool(const element&).
+	 */
+	template <class function_type> static void pre_order(const element& root, function_type&& func){
+		traverse<false>(root, std::forward<function_type>(func));
+	}
+
+	/**
+	 * @brief Traverse element tree in post-order.
+	 * Calls the function for each element of the tree, the children before their parent element.
+	 * @param root - root element of the tree.
+	 * @param func - function to call for each element. Signature is void(const element&).
+	 */
+	template <class function_type> static void post_order(const element& root, function_type&& func){
+		traverse<true>(root, std::forward<function_type>(func));
+	}
+};
+
+}
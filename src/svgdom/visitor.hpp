@@ -64,7 +64,7 @@ protected:
 	 * Returns iterator into the parent container of the currently visited child element.
 	 * Note, that removing the visited element from its parent during the element is visited will
 	 * lead to undefined behavior. Instead, one should store the iterators until the whole SVG tree
-	 * traversing is completed and only then perform elements removal if needed.
+	 * traversing is completed and only then perform elements removal if needed, see container::erase().
 	 * @return Iterator of currently visited child element.
 	 */
 	decltype(container::children)::iterator cur_iter()const{
@@ -0,0 +1,391 @@
+#include "bench.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <numeric>
+#include <algorithm>
+#include <iterator>
+
+#include "../../src/svgdom/config.hpp"
+
+using namespace bench;
+
+namespace{
+struct group{
+	std::string name;
+	std::function<void(suite&)> init;
+};
+
+std::vector<group>& get_groups(){
+	static std::vector<group> groups;
+	return groups;
+}
+
+volatile size_t sink;
+}
+
+void bench::consume(size_t value)noexcept{
+	sink = sink + value;
+}
+
+set::set(std::string name, std::function<void(suite&)> init){
+	get_groups().push_back(group{std::move(name), std::move(init)});
+}
+
+void suite::add(std::string name, work per_iteration, std::function<void()> func){
+	this->benchmarks.push_back(benchmark{std::move(name), per_iteration, std::move(func), std::string(), 0});
+}
+
+void suite::add(const std::string& series, size_t size, work per_iteration, std::function<void()> func){
+	this->benchmarks.push_back(benchmark{series + "/" + std::to_string(size), per_iteration, std::move(func), series, size});
+}
+
+double result::mb_per_sec()const{
+	if(this->median <= 0){
+		return 0;
+	}
+	return double(this->per_iteration.bytes) / this->median * 1e3;
+}
+
+double result::elements_per_sec()const{
+	if(this->median <= 0){
+		return 0;
+	}
+	return double(this->per_iteration.elements) / this->median * 1e9;
+}
+
+namespace{
+typedef std::chrono::steady_clock clock_type;
+
+// returns time of running the batch in seconds
+double time_batch(const std::function<void()>& func, size_t num_iterations){
+	auto start = clock_type::now();
+	for(size_t i = 0; i != num_iterations; ++i){
+		func();
+	}
+	return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+result measure(const std::function<void()>& func, const config& conf){
+	result ret;
+
+	// warm up caches and allocator, meanwhile find the batch size giving long enough samples
+	size_t batch_size = 1;
+	{
+		auto start = clock_type::now();
+		for(;;){
+			auto t = time_batch(func, batch_size);
+			if(t < conf.min_batch_time){
+				// scale the batch to the minimal batch time with some margin
+				batch_size = std::max(
+						batch_size * 2,
+						size_t(double(batch_size) * conf.min_batch_time * 1.2 / std::max(t, 1e-9))
+					);
+				continue;
+			}
+			if(std::chrono::duration<double>(clock_type::now() - start).count() >= conf.warmup_time){
+				break;
+			}
+		}
+	}
+
+	std::vector<double> samples;
+	{
+		auto start = clock_type::now();
+		while(samples.size() < conf.min_samples
+				|| (samples.size() < conf.max_samples && std::chrono::duration<double>(clock_type::now() - start).count() < conf.min_time)
+			)
+		{
+			samples.push_back(time_batch(func, batch_size) * 1e9 / double(batch_size));
+		}
+	}
+
+	ret.num_samples = samples.size();
+	ret.num_iterations = samples.size() * batch_size;
+
+	std::sort(samples.begin(), samples.end());
+
+	ret.min = samples.front();
+	ret.max = samples.back();
+
+	auto mid = samples.size() / 2;
+	ret.median = samples.size() % 2 == 0 ? (samples[mid - 1] + samples[mid]) / 2 : samples[mid];
+
+	ret.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / double(samples.size());
+
+	double sum_of_squares = 0;
+	for(auto s : samples){
+		sum_of_squares += (s - ret.mean) * (s - ret.mean);
+	}
+	ret.stddev = samples.size() > 1 ? std::sqrt(sum_of_squares / double(samples.size() - 1)) : 0;
+
+	return ret;
+}
+
+std::string format_time(double ns){
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	if(ns < 1e3){
+		ss << ns << " ns";
+	}else if(ns < 1e6){
+		ss << ns / 1e3 << " us";
+	}else if(ns < 1e9){
+		ss << ns / 1e6 << " ms";
+	}else{
+		ss << ns / 1e9 << " s";
+	}
+	return ss.str();
+}
+
+std::string format_rate(double per_sec){
+	if(per_sec <= 0){
+		return "-";
+	}
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	if(per_sec < 1e3){
+		ss << per_sec;
+	}else if(per_sec < 1e6){
+		ss << per_sec / 1e3 << " K";
+	}else{
+		ss << per_sec / 1e6 << " M";
+	}
+	return ss.str();
+}
+
+void log_header(std::ostream& o){
+	o << std::left << std::setw(48) << "benchmark"
+			<< std::right << std::setw(12) << "median"
+			<< std::setw(10) << "stddev"
+			<< std::setw(12) << "min"
+			<< std::setw(12) << "MB/s"
+			<< std::setw(14) << "elements/s"
+			<< std::setw(12) << "iterations"
+			<< std::endl;
+}
+
+void log_result(std::ostream& o, const result& r){
+	std::stringstream stddev;
+	stddev << std::fixed << std::setprecision(1) << (r.mean > 0 ? r.stddev / r.mean * 100 : 0) << "%";
+
+	std::stringstream mb_per_sec;
+	if(r.per_iteration.bytes != 0){
+		mb_per_sec << std::fixed << std::setprecision(2) << r.mb_per_sec();
+	}else{
+		mb_per_sec << "-";
+	}
+
+	o << std::left << std::setw(48) << r.name
+			<< std::right << std::setw(12) << format_time(r.median)
+			<< std::setw(10) << stddev.str()
+			<< std::setw(12) << format_time(r.min)
+			<< std::setw(12) << mb_per_sec.str()
+			<< std::setw(14) << format_rate(r.elements_per_sec())
+			<< std::setw(12) << r.num_iterations
+			<< std::endl;
+}
+
+void fit_exponent(scaling& s){
+	// least squares fit of log(time) = log(c) + k * log(size)
+	double n = double(s.points.size());
+	double sum_x = 0;
+	double sum_y = 0;
+	double sum_xx = 0;
+	double sum_xy = 0;
+	for(const auto& p : s.points){
+		double x = std::log(p.first);
+		double y = std::log(p.second);
+		sum_x += x;
+		sum_y += y;
+		sum_xx += x * x;
+		sum_xy += x * y;
+	}
+	double d = n * sum_xx - sum_x * sum_x;
+	s.exponent = d > 0 ? (n * sum_xy - sum_x * sum_y) / d : 0;
+}
+
+void log_scaling(std::ostream& o, const scaling& s){
+	o << std::left << std::setw(48) << (s.series + " scaling")
+			<< std::right << "time ~ size^" << std::fixed << std::setprecision(2) << s.exponent
+			<< std::defaultfloat << std::endl;
+}
+}
+
+report runner::run(const config& conf, std::ostream& log){
+	report ret;
+
+	log_header(log);
+
+	for(const auto& g : get_groups()){
+		suite s(conf);
+		g.init(s);
+
+		std::vector<scaling> scalings;
+
+		for(const auto& b : s.benchmarks){
+			auto name = g.name + "/" + b.name;
+			if(!conf.filter.empty() && name.find(conf.filter) == std::string::npos){
+				continue;
+			}
+
+			auto r = measure(b.func, conf);
+			r.name = std::move(name);
+			r.per_iteration = b.per_iteration;
+
+			log_result(log, r);
+
+			if(!b.series.empty()){
+				auto series = g.name + "/" + b.series;
+				auto i = std::find_if(scalings.begin(), scalings.end(), [&series](const auto& sc){
+					return sc.series == series;
+				});
+				if(i == scalings.end()){
+					scalings.push_back(scaling{series, {}, 0});
+					i = std::prev(scalings.end());
+				}
+				i->points.push_back(std::make_pair(double(b.size), r.median));
+			}
+
+			ret.results.push_back(std::move(r));
+		}
+
+		for(auto& sc : scalings){
+			if(sc.points.size() < 2){
+				continue;
+			}
+			fit_exponent(sc);
+			log_scaling(log, sc);
+			ret.scalings.push_back(std::move(sc));
+		}
+	}
+
+	return ret;
+}
+
+namespace{
+std::string escape_json(const std::string& str){
+	std::string ret;
+	for(auto c : str){
+		switch(c){
+			case '"':
+				ret.append("\\\"");
+				break;
+			case '\\':
+				ret.append("\\\\");
+				break;
+			default:
+				if(static_cast<unsigned char>(c) < 0x20){
+					std::stringstream ss;
+					ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << unsigned(c);
+					ret.append(ss.str());
+				}else{
+					ret.push_back(c);
+				}
+				break;
+		}
+	}
+	return ret;
+}
+
+const char* get_compiler(){
+#if defined(__clang__)
+	return "clang " __clang_version__;
+#elif defined(__GNUC__)
+	return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+	return "msvc";
+#else
+	return "unknown";
+#endif
+}
+}
+
+void bench::write_json(std::ostream& o, const config& conf, const report& rep){
+	std::string date;
+	{
+		auto t = std::time(nullptr);
+		std::array<char, sizeof("YYYY-MM-DDTHH:MM:SSZ")> buf;
+		if(std::strftime(buf.data(), buf.size(), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&t)) != 0){
+			date = buf.data();
+		}
+	}
+
+	o << std::setprecision(6);
+
+	o << "{" << '\n';
+	o << "\t\"context\": {" << '\n';
+	o << "\t\t\"date\": \"" << date << "\"," << '\n';
+	o << "\t\t\"compiler\": \"" << escape_json(get_compiler()) << "\"," << '\n';
+#ifdef NDEBUG
+	o << "\t\t\"debug\": false," << '\n';
+#else
+	o << "\t\t\"debug\": true," << '\n';
+#endif
+	o << "\t\t\"real_size\": " << sizeof(svgdom::real) << "," << '\n';
+	o << "\t\t\"contiguous_children\": " << (SVGDOM_CONTIGUOUS_CHILDREN ? "true" : "false") << "," << '\n';
+	o << "\t\t\"min_time\": " << conf.min_time << "," << '\n';
+	o << "\t\t\"min_samples\": " << conf.min_samples << '\n';
+	o << "\t}," << '\n';
+	o << "\t\"benchmarks\": [";
+
+	bool first = true;
+	for(const auto& r : rep.results){
+		if(first){
+			first = false;
+		}else{
+			o << ",";
+		}
+		o << '\n';
+		o << "\t\t{" << '\n';
+		o << "\t\t\t\"name\": \"" << escape_json(r.name) << "\"," << '\n';
+		o << "\t\t\t\"samples\": " << r.num_samples << "," << '\n';
+		o << "\t\t\t\"iterations\": " << r.num_iterations << "," << '\n';
+		o << "\t\t\t\"time_unit\": \"ns\"," << '\n';
+		o << "\t\t\t\"min\": " << r.min << "," << '\n';
+		o << "\t\t\t\"median\": " << r.median << "," << '\n';
+		o << "\t\t\t\"mean\": " << r.mean << "," << '\n';
+		o << "\t\t\t\"stddev\": " << r.stddev << "," << '\n';
+		o << "\t\t\t\"max\": " << r.max << "," << '\n';
+		o << "\t\t\t\"bytes_per_iteration\": " << r.per_iteration.bytes << "," << '\n';
+		o << "\t\t\t\"elements_per_iteration\": " << r.per_iteration.elements << "," << '\n';
+		o << "\t\t\t\"mb_per_sec\": " << r.mb_per_sec() << "," << '\n';
+		o << "\t\t\t\"elements_per_sec\": " << r.elements_per_sec() << '\n';
+		o << "\t\t}";
+	}
+	if(!rep.results.empty()){
+		o << '\n' << "\t";
+	}
+	o << "]," << '\n';
+	o << "\t\"scalings\": [";
+
+	first = true;
+	for(const auto& sc : rep.scalings){
+		if(first){
+			first = false;
+		}else{
+			o << ",";
+		}
+		o << '\n';
+		o << "\t\t{" << '\n';
+		o << "\t\t\t\"series\": \"" << escape_json(sc.series) << "\"," << '\n';
+		o << "\t\t\t\"exponent\": " << sc.exponent << "," << '\n';
+		o << "\t\t\t\"points\": [";
+		for(auto i = sc.points.begin(); i != sc.points.end(); ++i){
+			if(i != sc.points.begin()){
+				o << ", ";
+			}
+			o << "{\"size\": " << i->first << ", \"median\": " << i->second << "}";
+		}
+		o << "]" << '\n';
+		o << "\t\t}";
+	}
+	if(!rep.scalings.empty()){
+		o << '\n' << "\t";
+	}
+	o << "]" << '\n';
+	o << "}" << '\n';
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+
+// Minimal benchmarking harness.
+// Benchmarks are registered in groups with static bench::set objects, similar to tst::set in unit tests.
+// Each benchmark is warmed up, then timed with a high-resolution clock in batches of iterations,
+// and the per-iteration times of the batches are summarized into statistics.
+
+namespace bench{
+
+struct config{
+	// directory with the sample SVG files
+	std::string data_dir = "../unit/samples_data/";
+
+	// only benchmarks with full name containing this substring are run
+	std::string filter;
+
+	// minimal time of warming up each benchmark before measuring, in seconds
+	double warmup_time = 0.1;
+
+	// minimal time of measuring each benchmark, in seconds
+	double min_time = 0.5;
+
+	// minimal duration of one timed batch of iterations, in seconds,
+	// short benchmarks are run in batches to keep the clock resolution out of the measurements
+	double min_batch_time = 1e-3;
+
+	unsigned min_samples = 10;
+	unsigned max_samples = 1000;
+
+	// run scaling benchmarks also on the largest synthetic documents, which takes a lot of time and memory
+	bool large = false;
+};
+
+// Amount of work done by one iteration of a benchmark, used to calculate the throughput.
+struct work{
+	size_t bytes = 0;
+	size_t elements = 0;
+};
+
+struct result{
+	std::string name;
+
+	work per_iteration;
+
+	size_t num_samples = 0;
+	size_t num_iterations = 0;
+
+	// time of one iteration in nanoseconds
+	double min = 0;
+	double median = 0;
+	double mean = 0;
+	double stddev = 0;
+	double max = 0;
+
+	// throughput calculated from median time, zero if amount of work is not known
+	double mb_per_sec()const;
+	double elements_per_sec()const;
+};
+
+// Scaling curve of benchmarks of one series.
+struct scaling{
+	std::string series;
+
+	// problem size and median time of one iteration in nanoseconds
+	std::vector<std::pair<double, double>> points;
+
+	// exponent k of the least squares fit of the points to time = c * size^k,
+	// close to 1 for linear algorithms and close to 2 for quadratic ones
+	double exponent = 0;
+};
+
+struct report{
+	std::vector<result> results;
+	std::vector<scaling> scalings;
+};
+
+class suite{
+	friend class runner;
+
+	struct benchmark{
+		std::string name;
+		work per_iteration;
+		std::function<void()> func;
+
+		// scaling series the benchmark belongs to, empty if none
+		std::string series;
+		size_t size = 0;
+	};
+
+	std::vector<benchmark> benchmarks;
+
+	const config& conf;
+
+	suite(const config& conf) :
+			conf(conf)
+	{}
+public:
+	const config& get_config()const noexcept{
+		return this->conf;
+	}
+
+	/**
+	 * @brief Add benchmark to the group.
+	 * @param name - name of the benchmark, unique within the group.
+	 * @param per_iteration - amount of work done by one call to the benchmark function.
+	 * @param func - benchmark function, performs one iteration.
+	 */
+	void add(std::string name, work per_iteration, std::function<void()> func);
+
+	/**
+	 * @brief Add benchmark which is a point of a scaling curve.
+	 * Times of all benchmarks of the series are fitted to power function of the problem size,
+	 * and the exponent is reported along with the results, so that changes in asymptotic behavior can be noticed.
+	 * The benchmark is named as "<series>/<size>".
+	 * @param series - name of the series.
+	 * @param size - problem size, e.g. number of elements in the document.
+	 * @param per_iteration - amount of work done by one call to the benchmark function.
+	 * @param func - benchmark function, performs one iteration.
+	 */
+	void add(const std::string& series, size_t size, work per_iteration, std::function<void()> func);
+};
+
+class set{
+public:
+	/**
+	 * @brief Register group of benchmarks.
+	 * The initializer is called before running the group, it prepares the data and adds benchmarks to the suite.
+	 * @param name - name of the group.
+	 * @param init - group initializer.
+	 */
+	set(std::string name, std::function<void(suite&)> init);
+};
+
+class runner{
+public:
+	static report run(const config& conf, std::ostream& log);
+};
+
+void write_json(std::ostream& o, const config& conf, const report& r);
+
+// prevents the compiler from optimizing away calculation of the value
+void consume(size_t value)noexcept;
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <string_view>
+
+#include <papki/fs_file.hpp>
+
+#include "../../src/svgdom/elements/element.hpp"
+#include "../../src/svgdom/util/traversal.hpp"
+
+#include "bench.hpp"
+
+namespace bench{
+
+// sample files used by benchmarks, from small to large
+const std::vector<std::string> sample_files = {"tiger.svg", "camera.svg", "car.svg", "test2.svg"};
+
+inline std::vector<uint8_t> load_sample(const config& conf, const std::string& file_name){
+	return papki::fs_file(conf.data_dir + file_name).load();
+}
+
+inline size_t count_elements(const svgdom::element& root){
+	size_t ret = 0;
+	svgdom::traversal::pre_order(root, [&ret](const svgdom::element&){
+		++ret;
+	});
+	return ret;
+}
+
+// extracts values of all attributes with given name from the SVG file text
+inline std::vector<std::string> extract_attribute(const std::vector<uint8_t>& svg, std::string_view name){
+	std::string_view s(reinterpret_cast<const char*>(svg.data()), svg.size());
+
+	std::vector<std::string> ret;
+
+	std::string attr(name);
+	attr.append("=\"");
+
+	for(auto pos = s.find(attr); pos != std::string_view::npos; pos = s.find(attr, pos)){
+		bool is_attr_start = pos != 0 && (s[pos - 1] == ' ' || s[pos - 1] == '\t' || s[pos - 1] == '\n' || s[pos - 1] == '\r');
+		pos += attr.size();
+		auto end = s.find('"', pos);
+		if(end == std::string_view::npos){
+			break;
+		}
+		if(is_attr_start){
+			ret.emplace_back(s.substr(pos, end - pos));
+		}
+		pos = end;
+	}
+
+	return ret;
+}
+
+inline size_t total_size(const std::vector<std::string>& strings){
+	size_t ret = 0;
+	for(const auto& s : strings){
+		ret += s.size();
+	}
+	return ret;
+}
+
+}
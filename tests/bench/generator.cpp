@@ -0,0 +1,259 @@
+#include "generator.hpp"
+
+#include <vector>
+#include <algorithm>
+
+using namespace bench;
+
+namespace{
+class generator{
+	const corpus_params& params;
+
+	// splitmix64, unlike std:: distributions it gives same numbers with any standard library
+	uint64_t state;
+
+	uint64_t next(){
+		uint64_t z = (this->state += 0x9e3779b97f4a7c15);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+		return z ^ (z >> 31);
+	}
+
+	unsigned uniform(unsigned n){
+		return unsigned(this->next() % n);
+	}
+
+	// returns number from [0, 1)
+	double uniform_real(){
+		return double(this->next() >> 11) / double(uint64_t(1) << 53);
+	}
+
+	bool chance(double probability){
+		return this->uniform_real() < probability;
+	}
+
+	std::string out;
+
+	size_t num_generated = 0;
+	size_t num_uses_left;
+
+	// ids of generated shape elements, which can be referred by 'use' elements
+	std::vector<size_t> shape_ids;
+
+	unsigned num_classes()const{
+		return std::max(this->params.num_css_rules, 16u);
+	}
+
+	void append_coordinate(){
+		this->out.append(std::to_string(this->uniform(1000)));
+		this->out.push_back('.');
+		this->out.append(std::to_string(this->uniform(10)));
+	}
+
+	void append_color(){
+		const char* digits = "0123456789abcdef";
+		this->out.push_back('#');
+		auto c = this->uniform(0x1000000);
+		for(unsigned i = 0; i != 6; ++i){
+			this->out.push_back(digits[(c >> (20 - i * 4)) & 0xf]);
+		}
+	}
+
+	void generate_css(){
+		this->out.append("<style type=\"text/css\"><![CDATA[\n");
+		for(unsigned i = 0; i != this->params.num_css_rules; ++i){
+			auto cls = "c" + std::to_string(i);
+			switch(i % 3){
+				case 0:
+					this->out.append("." + cls);
+					break;
+				case 1:
+					this->out.append("path." + cls);
+					break;
+				default:
+					this->out.append("g ." + cls);
+					break;
+			}
+			this->out.append("{fill:");
+			this->append_color();
+			this->out.append(";stroke:");
+			this->append_color();
+			this->out.append(";stroke-width:" + std::to_string(1 + this->uniform(5)) + "}\n");
+		}
+		this->out.append("]]></style>\n");
+	}
+
+	// appends opening tag name, id and common attributes
+	void open_element(const char* tag){
+		auto id = this->num_generated++;
+
+		this->out.push_back('<');
+		this->out.append(tag);
+		this->out.append(" id=\"e" + std::to_string(id) + "\"");
+
+		if(this->chance(this->params.class_density)){
+			this->out.append(" class=\"c" + std::to_string(this->uniform(this->num_classes())) + "\"");
+		}
+	}
+
+	void generate_path(){
+		this->out.append(" d=\"M");
+		this->append_coordinate();
+		this->out.push_back(' ');
+		this->append_coordinate();
+
+		for(unsigned i = 1; i < this->params.path_steps; ++i){
+			switch(this->uniform(5)){
+				case 0:
+					this->out.append(" L");
+					this->append_coordinate();
+					this->out.push_back(' ');
+					this->append_coordinate();
+					break;
+				case 1:
+					this->out.append(" c");
+					for(unsigned j = 0; j != 6; ++j){
+						if(j != 0){
+							this->out.push_back(' ');
+						}
+						this->out.append(std::to_string(int(this->uniform(41)) - 20));
+					}
+					break;
+				case 2:
+					this->out.append(" Q");
+					for(unsigned j = 0; j != 4; ++j){
+						if(j != 0){
+							this->out.push_back(' ');
+						}
+						this->append_coordinate();
+					}
+					break;
+				case 3:
+					this->out.append(" a10 20 30 0 1 ");
+					this->append_coordinate();
+					this->out.push_back(' ');
+					this->append_coordinate();
+					break;
+				default:
+					this->out.append(this->chance(0.5) ? " h" : " v");
+					this->out.append(std::to_string(int(this->uniform(41)) - 20));
+					break;
+			}
+		}
+		this->out.append(" z\"");
+	}
+
+	void generate_leaf(){
+		size_t num_left = this->params.num_elements - this->num_generated;
+		if(this->num_uses_left != 0
+				&& !this->shape_ids.empty()
+				&& this->chance(double(this->num_uses_left) / double(num_left))
+			)
+		{
+			--this->num_uses_left;
+			auto ref = this->shape_ids[this->uniform(unsigned(this->shape_ids.size()))];
+			this->open_element("use");
+			this->out.append(" xlink:href=\"#e" + std::to_string(ref) + "\" x=\"");
+			this->append_coordinate();
+			this->out.append("\"/>\n");
+			return;
+		}
+
+		this->shape_ids.push_back(this->num_generated);
+
+		switch(this->uniform(4)){
+			case 0:
+				this->open_element("rect");
+				this->out.append(" x=\"");
+				this->append_coordinate();
+				this->out.append("\" y=\"");
+				this->append_coordinate();
+				this->out.append("\" width=\"" + std::to_string(1 + this->uniform(100)));
+				this->out.append("\" height=\"" + std::to_string(1 + this->uniform(100)) + "\"");
+				break;
+			case 1:
+				this->open_element("circle");
+				this->out.append(" cx=\"");
+				this->append_coordinate();
+				this->out.append("\" cy=\"");
+				this->append_coordinate();
+				this->out.append("\" r=\"" + std::to_string(1 + this->uniform(50)) + "\"");
+				break;
+			default:
+				this->open_element("path");
+				this->generate_path();
+				break;
+		}
+
+		if(this->chance(0.3)){
+			this->out.append(" style=\"fill:");
+			this->append_color();
+			this->out.append(";opacity:0.5\"");
+		}
+		if(this->chance(0.2)){
+			this->out.append(" stroke=\"");
+			this->append_color();
+			this->out.append("\"");
+		}
+
+		this->out.append("/>\n");
+	}
+
+	// level is the nesting depth of the group, starting from 1
+	void generate_group(unsigned level){
+		this->open_element("g");
+		if(this->chance(0.2)){
+			this->out.append(" transform=\"translate(");
+			this->append_coordinate();
+			this->out.push_back(' ');
+			this->append_coordinate();
+			this->out.append(")\"");
+		}
+		this->out.append(">\n");
+
+		for(unsigned i = 0; i != this->params.fan_out && this->num_generated < this->params.num_elements; ++i){
+			// first child is a group to make sure the document reaches the requested depth
+			if(level < this->params.depth && (i == 0 || this->chance(0.3))){
+				this->generate_group(level + 1);
+			}else{
+				this->generate_leaf();
+			}
+		}
+
+		this->out.append("</g>\n");
+	}
+
+public:
+	generator(const corpus_params& params) :
+			params(params),
+			state(params.seed),
+			num_uses_left(params.num_uses)
+	{}
+
+	std::string generate(){
+		this->out.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+		this->out.append(
+				"<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\""
+				" width=\"1000\" height=\"1000\" viewBox=\"0 0 1000 1000\">\n"
+			);
+
+		this->generate_css();
+
+		while(this->num_generated < this->params.num_elements){
+			if(this->params.depth != 0 && this->params.fan_out != 0){
+				this->generate_group(1);
+			}else{
+				this->generate_leaf();
+			}
+		}
+
+		this->out.append("</svg>\n");
+
+		return std::move(this->out);
+	}
+};
+}
+
+std::string bench::generate_svg(const corpus_params& params){
+	return generator(params).generate();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Deterministic generator of synthetic SVG documents for scaling benchmarks.
+// Same parameters always produce the same document, on any platform.
+
+namespace bench{
+
+struct corpus_params{
+	// total number of elements in the document, not counting the root 'svg', 'defs' and 'style' elements
+	size_t num_elements = 10000;
+
+	// maximal nesting depth of 'g' elements
+	unsigned depth = 8;
+
+	// maximal number of children of a 'g' element
+	unsigned fan_out = 10;
+
+	// number of steps in each 'path' element
+	unsigned path_steps = 8;
+
+	// number of rules in the CSS style sheet
+	unsigned num_css_rules = 50;
+
+	// fraction of elements having the 'class' attribute, from [0, 1]
+	double class_density = 0.5;
+
+	// number of 'use' elements, each referring to one of the preceding shape elements
+	size_t num_uses = 100;
+
+	uint64_t seed = 1;
+};
+
+std::string generate_svg(const corpus_params& params);
+
+}
@@ -0,0 +1,57 @@
+#include <sstream>
+
+#include "../../src/svgdom/dom.hpp"
+
+#include "common.hpp"
+
+namespace{
+bench::set set("load", [](bench::suite& s){
+	for(const auto& f : bench::sample_files){
+		auto data = std::make_shared<std::vector<uint8_t>>(bench::load_sample(s.get_config(), f));
+
+		auto dom = svgdom::load(utki::make_span(*data));
+		if(!dom){
+			throw std::runtime_error("could not load " + f);
+		}
+
+		bench::work w;
+		w.bytes = data->size();
+		w.elements = bench::count_elements(*dom);
+
+		s.add("buffer/" + f, w, [data](){
+			bench::consume(svgdom::load(utki::make_span(*data))->children.size());
+		});
+
+		s.add("file/" + f, w, [path = s.get_config().data_dir + f](){
+			bench::consume(svgdom::load(papki::fs_file(path))->children.size());
+		});
+
+		// stream creation copies the data, the copying is a part of the benchmark
+		auto str = std::make_shared<std::string>(reinterpret_cast<const char*>(data->data()), data->size());
+		s.add("stream/" + f, w, [str](){
+			std::istringstream ss(*str);
+			bench::consume(svgdom::load(ss)->children.size());
+		});
+
+		s.add("arena/" + f, w, [data](){
+			svgdom::load_options options;
+			options.use_arena = true;
+			bench::consume(svgdom::load(utki::make_span(*data), options)->children.size());
+		});
+
+		// loading with statistics gathering, to see the instrumentation overhead
+		s.add("stats/" + f, w, [data](){
+			svgdom::load_stats stats;
+			svgdom::load_options options;
+			options.stats = &stats;
+			bench::consume(svgdom::load(utki::make_span(*data), options)->children.size());
+		});
+
+		s.add("lazy/" + f, w, [data](){
+			svgdom::load_options options;
+			options.lazy_parsing = true;
+			bench::consume(svgdom::load(utki::make_span(*data), options)->children.size());
+		});
+	}
+});
+}
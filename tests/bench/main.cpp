@@ -0,0 +1,124 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <string_view>
+
+#include "bench.hpp"
+#include "generator.hpp"
+
+namespace{
+void print_help(std::ostream& o){
+	const bench::corpus_params defaults;
+
+	o << "usage: bench [options]" << std::endl;
+	o << "options:" << std::endl;
+	o << "  --data-dir <dir>    directory with sample SVG files, default is ../unit/samples_data/" << std::endl;
+	o << "  --filter <str>      run only benchmarks with name containing the string" << std::endl;
+	o << "  --min-time <sec>    minimal measuring time of each benchmark, default is 0.5" << std::endl;
+	o << "  --json <file>       write results to the file in JSON format" << std::endl;
+	o << "  --large             run scaling benchmarks also on the largest synthetic documents" << std::endl;
+	o << "  --help              show this help" << std::endl;
+	o << std::endl;
+	o << "usage: bench --generate <file> [generator options]" << std::endl;
+	o << "writes synthetic SVG document to the file, generator options:" << std::endl;
+	o << "  --elements <num>         number of elements, default is " << defaults.num_elements << std::endl;
+	o << "  --depth <num>            maximal nesting depth of groups, default is " << defaults.depth << std::endl;
+	o << "  --fan-out <num>          maximal number of group children, default is " << defaults.fan_out << std::endl;
+	o << "  --path-steps <num>       number of steps in each path, default is " << defaults.path_steps << std::endl;
+	o << "  --css-rules <num>        number of CSS rules, default is " << defaults.num_css_rules << std::endl;
+	o << "  --class-density <frac>   fraction of elements with class attribute, default is " << defaults.class_density << std::endl;
+	o << "  --uses <num>             number of 'use' elements, default is " << defaults.num_uses << std::endl;
+	o << "  --seed <num>             random seed, default is " << defaults.seed << std::endl;
+}
+}
+
+int main(int argc, char** argv){
+	bench::config conf;
+	std::string json_file;
+
+	bench::corpus_params corpus;
+	std::string generate_file;
+
+	for(int i = 1; i < argc; ++i){
+		std::string_view arg = argv[i];
+
+		if(arg == "--help"){
+			print_help(std::cout);
+			return 0;
+		}else if(arg == "--large"){
+			conf.large = true;
+			continue;
+		}
+
+		if(i + 1 == argc){
+			std::cerr << "error: unknown option or missing value: " << arg << std::endl;
+			print_help(std::cerr);
+			return 1;
+		}
+
+		std::string value = argv[++i];
+
+		if(arg == "--data-dir"){
+			conf.data_dir = value;
+			if(!conf.data_dir.empty() && conf.data_dir.back() != '/'){
+				conf.data_dir.push_back('/');
+			}
+		}else if(arg == "--filter"){
+			conf.filter = value;
+		}else if(arg == "--min-time"){
+			conf.min_time = std::strtod(value.c_str(), nullptr);
+		}else if(arg == "--json"){
+			json_file = value;
+		}else if(arg == "--generate"){
+			generate_file = value;
+		}else if(arg == "--elements"){
+			corpus.num_elements = std::strtoull(value.c_str(), nullptr, 0);
+		}else if(arg == "--depth"){
+			corpus.depth = unsigned(std::strtoul(value.c_str(), nullptr, 0));
+		}else if(arg == "--fan-out"){
+			corpus.fan_out = unsigned(std::strtoul(value.c_str(), nullptr, 0));
+		}else if(arg == "--path-steps"){
+			corpus.path_steps = unsigned(std::strtoul(value.c_str(), nullptr, 0));
+		}else if(arg == "--css-rules"){
+			corpus.num_css_rules = unsigned(std::strtoul(value.c_str(), nullptr, 0));
+		}else if(arg == "--class-density"){
+			corpus.class_density = std::strtod(value.c_str(), nullptr);
+		}else if(arg == "--uses"){
+			corpus.num_uses = std::strtoull(value.c_str(), nullptr, 0);
+		}else if(arg == "--seed"){
+			corpus.seed = std::strtoull(value.c_str(), nullptr, 0);
+		}else{
+			std::cerr << "error: unknown option: " << arg << std::endl;
+			print_help(std::cerr);
+			return 1;
+		}
+	}
+
+	try{
+		if(!generate_file.empty()){
+			std::ofstream f(generate_file, std::ios::binary);
+			if(!f){
+				std::cerr << "error: could not open file for writing: " << generate_file << std::endl;
+				return 1;
+			}
+			f << bench::generate_svg(corpus);
+			return 0;
+		}
+
+		auto results = bench::runner::run(conf, std::cout);
+
+		if(!json_file.empty()){
+			std::ofstream f(json_file);
+			if(!f){
+				std::cerr << "error: could not open file for writing: " << json_file << std::endl;
+				return 1;
+			}
+			bench::write_json(f, conf, results);
+		}
+	}catch(std::exception& e){
+		std::cerr << "error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include "../../src/svgdom/elements/shapes.hpp"
+#include "../../src/svgdom/elements/styleable.hpp"
+#include "../../src/svgdom/elements/transformable.hpp"
+
+#include "common.hpp"
+
+namespace{
+// extracts values of color properties from the style attributes values
+std::vector<std::string> extract_colors(const std::vector<std::string>& styles){
+	std::vector<std::string> ret;
+	for(const auto& style : styles){
+		std::string_view s(style);
+		while(!s.empty()){
+			auto end = std::min(s.find(';'), s.size());
+			auto decl = s.substr(0, end);
+			s = s.substr(std::min(end + 1, s.size()));
+
+			auto colon = decl.find(':');
+			if(colon == std::string_view::npos){
+				continue;
+			}
+			auto name = decl.substr(0, colon);
+			while(!name.empty() && name.front() == ' '){
+				name = name.substr(1);
+			}
+			if(name == "fill" || name == "stroke" || name == "stop-color" || name == "flood-color"){
+				ret.emplace_back(decl.substr(colon + 1));
+			}
+		}
+	}
+	return ret;
+}
+
+template <class parse_function> void add_parse_benchmark(
+		bench::suite& s,
+		const std::string& name,
+		const std::vector<std::string>& data,
+		parse_function parse
+	)
+{
+	if(data.empty()){
+		return;
+	}
+
+	bench::work w;
+	w.bytes = bench::total_size(data);
+	w.elements = data.size();
+
+	s.add(name, w, [data = std::make_shared<std::vector<std::string>>(data), parse](){
+		for(const auto& d : *data){
+			parse(d);
+		}
+	});
+}
+
+bench::set set("parse", [](bench::suite& s){
+	std::vector<std::string> all_transforms;
+
+	for(const auto& f : bench::sample_files){
+		auto data = bench::load_sample(s.get_config(), f);
+
+		add_parse_benchmark(s, "path/" + f, bench::extract_attribute(data, "d"), [](std::string_view str){
+			bench::consume(svgdom::path_element::parse(str).size());
+		});
+
+		auto styles = bench::extract_attribute(data, "style");
+
+		add_parse_benchmark(s, "style/" + f, styles, [](std::string_view str){
+			bench::consume(svgdom::styleable::parse(str).size());
+		});
+
+		add_parse_benchmark(s, "color/" + f, extract_colors(styles), [](std::string_view str){
+			bench::consume(svgdom::parse_paint(str).index());
+		});
+
+		for(auto attr : {"transform", "gradientTransform", "patternTransform"}){
+			auto t = bench::extract_attribute(data, attr);
+			all_transforms.insert(all_transforms.end(), t.begin(), t.end());
+		}
+	}
+
+	// sample files have few transformations each, so benchmark them all at once
+	add_parse_benchmark(s, "transform/all", all_transforms, [](std::string_view str){
+		bench::consume(svgdom::transformable::parse(str).size());
+	});
+});
+}
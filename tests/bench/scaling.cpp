@@ -0,0 +1,168 @@
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/elements/style.hpp"
+#include "../../src/svgdom/util/casters.hpp"
+#include "../../src/svgdom/util/style_stack.hpp"
+#include "../../src/svgdom/util/style_stack_cache.hpp"
+#include "../../src/svgdom/util/finder_by_id.hpp"
+#include "../../src/svgdom/util/finder_by_class.hpp"
+#include "../../src/svgdom/util/finder_by_tag.hpp"
+
+#include "common.hpp"
+#include "generator.hpp"
+
+namespace{
+// resolves fill of every element with style_stack, the way renderers do
+class fill_resolver : public svgdom::const_visitor{
+	svgdom::style_stack ss;
+public:
+	size_t num_resolved = 0;
+
+	void visit(const svgdom::style_element& e)override{
+		this->ss.add_css(e.css);
+	}
+
+	void default_visit(const svgdom::element& e)override{
+		auto s = svgdom::cast_to_styleable(&e);
+		if(!s){
+			return;
+		}
+		svgdom::style_stack::push push(this->ss, *s);
+		if(this->ss.get_style_property(svgdom::style_property::fill)){
+			++this->num_resolved;
+		}
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		auto s = svgdom::cast_to_styleable(&e);
+		if(!s){
+			this->relay_accept(c);
+			return;
+		}
+		svgdom::style_stack::push push(this->ss, *s);
+		this->relay_accept(c);
+	}
+};
+
+struct document{
+	std::shared_ptr<const std::string> text;
+	std::shared_ptr<const svgdom::svg_element> dom;
+	bench::work per_iteration;
+};
+
+document make_document(const bench::corpus_params& params){
+	document ret;
+	ret.text = std::make_shared<std::string>(bench::generate_svg(params));
+
+	auto dom = svgdom::load(*ret.text);
+	if(!dom){
+		throw std::runtime_error("could not load generated document");
+	}
+	ret.per_iteration.bytes = ret.text->size();
+	ret.per_iteration.elements = bench::count_elements(*dom);
+	ret.dom = std::move(dom);
+
+	return ret;
+}
+
+void add_load(bench::suite& s, const std::string& series, size_t size, const document& doc){
+	bench::work w = doc.per_iteration;
+	s.add(series, size, w, [text = doc.text](){
+		bench::consume(svgdom::load(*text)->children.size());
+	});
+}
+
+void add_style_stack(bench::suite& s, const std::string& series, size_t size, const document& doc){
+	bench::work w;
+	w.elements = doc.per_iteration.elements;
+	s.add(series, size, w, [dom = doc.dom](){
+		fill_resolver r;
+		dom->accept(r);
+		bench::consume(r.num_resolved);
+	});
+}
+
+void add_style_stack_cache(bench::suite& s, const std::string& series, size_t size, const document& doc){
+	bench::work w;
+	w.elements = doc.per_iteration.elements;
+	s.add(series, size, w, [dom = doc.dom](){
+		svgdom::style_stack_cache cache(*dom);
+		bench::consume(cache.size());
+	});
+}
+
+bench::set set("scale", [](bench::suite& s){
+	// number of elements, the document is about 100 bytes per element
+	{
+		std::vector<size_t> sizes = {1000, 10000, 100000};
+		if(s.get_config().large){
+			sizes.push_back(1000000);
+		}
+
+		for(auto n : sizes){
+			bench::corpus_params params;
+			params.num_elements = n;
+			params.num_uses = n / 100;
+
+			auto doc = make_document(params);
+
+			bench::work w;
+			w.elements = doc.per_iteration.elements;
+
+			add_load(s, "elements/load", n, doc);
+			add_style_stack(s, "elements/style_stack", n, doc);
+			add_style_stack_cache(s, "elements/style_stack_cache", n, doc);
+
+			s.add("elements/finder_by_id", n, w, [dom = doc.dom](){
+				svgdom::finder_by_id finder(*dom);
+				bench::consume(finder.size());
+			});
+
+			s.add("elements/finder_by_class", n, w, [dom = doc.dom](){
+				svgdom::finder_by_class finder(*dom);
+				bench::consume(finder.size());
+			});
+
+			s.add("elements/finder_by_tag", n, w, [dom = doc.dom](){
+				svgdom::finder_by_tag finder(*dom);
+				bench::consume(finder.size());
+			});
+		}
+	}
+
+	// nesting depth, with binary tree of groups of the same number of elements
+	for(unsigned depth : {10, 100, 1000}){
+		bench::corpus_params params;
+		params.depth = depth;
+		params.fan_out = 2;
+
+		auto doc = make_document(params);
+
+		add_load(s, "depth/load", depth, doc);
+		add_style_stack(s, "depth/style_stack", depth, doc);
+		add_style_stack_cache(s, "depth/style_stack_cache", depth, doc);
+	}
+
+	// number of CSS rules, each element is matched against all of them
+	for(unsigned num_rules : {10, 100, 1000}){
+		bench::corpus_params params;
+		params.num_css_rules = num_rules;
+
+		auto doc = make_document(params);
+
+		add_style_stack(s, "css_rules/style_stack", num_rules, doc);
+	}
+
+	// number of steps in each path
+	for(unsigned num_steps : {10, 100, 1000}){
+		bench::corpus_params params;
+		params.num_elements = 1000;
+		params.path_steps = num_steps;
+		params.num_uses = 0;
+
+		auto doc = make_document(params);
+
+		add_load(s, "path_steps/load", num_steps, doc);
+	}
+});
+}
@@ -0,0 +1,102 @@
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/util/cloner.hpp"
+#include "../../src/svgdom/util/finder_by_id.hpp"
+#include "../../src/svgdom/util/finder_by_class.hpp"
+#include "../../src/svgdom/util/finder_by_tag.hpp"
+#include "../../src/svgdom/util/style_stack_cache.hpp"
+#include "../../src/svgdom/util/computed_styles.hpp"
+
+#include "common.hpp"
+
+namespace{
+class element_counter : public svgdom::const_visitor{
+public:
+	size_t num_elements = 0;
+
+	void default_visit(const svgdom::element& e)override{
+		++this->num_elements;
+	}
+};
+
+bench::set set("util", [](bench::suite& s){
+	for(const auto& f : bench::sample_files){
+		std::shared_ptr<const svgdom::svg_element> dom = svgdom::load(papki::fs_file(s.get_config().data_dir + f));
+		if(!dom){
+			throw std::runtime_error("could not load " + f);
+		}
+
+		auto ids = std::make_shared<std::vector<std::string>>();
+		svgdom::traversal::pre_order(*dom, [&ids](const svgdom::element& e){
+			if(!e.id.empty()){
+				ids->push_back(e.id);
+			}
+		});
+
+		bench::work w;
+		w.elements = bench::count_elements(*dom);
+
+		bench::work lookups;
+		lookups.elements = ids->size();
+
+		s.add("traversal.visitor/" + f, w, [dom](){
+			element_counter c;
+			dom->accept(c);
+			bench::consume(c.num_elements);
+		});
+
+		s.add("traversal.pre_order/" + f, w, [dom](){
+			bench::consume(bench::count_elements(*dom));
+		});
+
+		s.add("finder_by_id/" + f, w, [dom](){
+			svgdom::finder_by_id finder(*dom);
+			bench::consume(finder.size());
+		});
+
+		if(!ids->empty()){
+			auto finder = std::make_shared<svgdom::finder_by_id>(*dom);
+			s.add("finder_by_id.find/" + f, lookups, [dom, finder, ids](){
+				for(const auto& id : *ids){
+					bench::consume(finder->find(id) != nullptr);
+				}
+			});
+		}
+
+		s.add("finder_by_class/" + f, w, [dom](){
+			svgdom::finder_by_class finder(*dom);
+			bench::consume(finder.size());
+		});
+
+		s.add("finder_by_tag/" + f, w, [dom](){
+			svgdom::finder_by_tag finder(*dom);
+			bench::consume(finder.size());
+		});
+
+		s.add("style_stack_cache/" + f, w, [dom](){
+			svgdom::style_stack_cache cache(*dom);
+			bench::consume(cache.size());
+		});
+
+		if(!ids->empty()){
+			auto cache = std::make_shared<svgdom::style_stack_cache>(*dom);
+			s.add("style_stack_cache.find/" + f, lookups, [dom, cache, ids](){
+				for(const auto& id : *ids){
+					bench::consume(cache->find(id) != nullptr);
+				}
+			});
+		}
+
+		s.add("computed_styles/" + f, w, [dom](){
+			svgdom::computed_styles styles(*dom);
+			bench::consume(styles.size());
+		});
+
+		s.add("cloner/" + f, w, [dom](){
+			svgdom::cloner c;
+			dom->accept(c);
+			bench::consume(c.get_clone_as<svgdom::svg_element>()->children.size());
+		});
+	}
+});
+}
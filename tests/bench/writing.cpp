@@ -0,0 +1,47 @@
+#include <sstream>
+
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/util/stream_writer.hpp"
+#include "../../src/svgdom/util/parallel_writer.hpp"
+
+#include "common.hpp"
+
+namespace{
+bench::set set("write", [](bench::suite& s){
+	for(const auto& f : bench::sample_files){
+		std::shared_ptr<const svgdom::svg_element> dom = svgdom::load(papki::fs_file(s.get_config().data_dir + f));
+		if(!dom){
+			throw std::runtime_error("could not load " + f);
+		}
+
+		svgdom::write_options compact_options;
+		compact_options.compact = true;
+
+		bench::work w;
+		w.elements = bench::count_elements(*dom);
+		w.bytes = dom->to_string().size();
+
+		bench::work compact_w = w;
+		compact_w.bytes = dom->to_string(compact_options).size();
+
+		s.add("stream_writer/" + f, w, [dom](){
+			std::stringstream ss;
+			svgdom::stream_writer writer(ss);
+			dom->accept(writer);
+			bench::consume(size_t(ss.tellp()));
+		});
+
+		s.add("to_string/" + f, w, [dom](){
+			bench::consume(dom->to_string().size());
+		});
+
+		s.add("to_string.compact/" + f, compact_w, [dom, compact_options](){
+			bench::consume(dom->to_string(compact_options).size());
+		});
+
+		s.add("parallel_writer/" + f, w, [dom](){
+			bench::consume(svgdom::parallel_writer::to_string(*dom).size());
+		});
+	}
+});
+}
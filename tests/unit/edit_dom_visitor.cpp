@@ -91,5 +91,80 @@ tst::set set("edit_dom_visitor", [](auto& suite){
 		tst::check(dynamic_cast<svgdom::g_element*>((++dom->children.begin())->get()), SL);
 		tst::check_eq(dynamic_cast<svgdom::g_element*>((++dom->children.begin())->get())->children.size(), size_t(0), SL);
 	});
+
+	suite.add("erase_several_siblings", [](){
+		auto dom = std::make_unique<svgdom::svg_element>();
+
+		for(unsigned i = 0; i != 10; ++i){
+			if(i % 3 == 0){
+				dom->children.push_back(std::make_unique<svgdom::line_element>());
+			}else{
+				auto p = std::make_unique<svgdom::path_element>();
+				p->id = std::to_string(i);
+				dom->children.push_back(std::move(p));
+			}
+		}
+
+		// collect iterators of all 'line' elements during traversal, erase them afterwards
+		class line_collector : public svgdom::visitor{
+		public:
+			std::vector<svgdom::container::children_type::iterator> lines;
+
+			void visit(svgdom::svg_element& e) override{
+				this->relay_accept(e);
+			}
+
+			void visit(svgdom::line_element& e) override{
+				this->lines.push_back(this->cur_iter());
+			}
+		} visitor;
+
+		dom->accept(visitor);
+
+		tst::check_eq(visitor.lines.size(), size_t(4), SL);
+
+		dom->erase(utki::make_span(visitor.lines));
+
+		tst::check_eq(dom->children.size(), size_t(6), SL);
+
+		std::string ids;
+		for(const auto& c : dom->children){
+			tst::check(dynamic_cast<svgdom::path_element*>(c.get()), SL);
+			ids += c->id;
+		}
+		tst::check_eq(ids, std::string("124578"), SL);
+	});
+
+	suite.add("erase_keeps_null_children", [](){
+		auto dom = std::make_unique<svgdom::svg_element>();
+
+		// '0' stands for nullptr child, a letter stands for path element with the letter as id
+		const std::string layout = "0a0b0c0";
+		std::vector<svgdom::container::children_type::iterator> to_erase;
+		for(auto c : layout){
+			if(c == '0'){
+				dom->children.push_back(nullptr);
+				continue;
+			}
+			auto p = std::make_unique<svgdom::path_element>();
+			p->id = std::string(1, c);
+			dom->children.push_back(std::move(p));
+		}
+
+		// erase 'c' and then 'a', iterators are collected after all children are added
+		for(auto i = dom->children.begin(); i != dom->children.end(); ++i){
+			if(*i && (*i)->id != "b"){
+				to_erase.insert(to_erase.begin(), i);
+			}
+		}
+
+		dom->erase(utki::make_span(to_erase));
+
+		std::string result;
+		for(const auto& c : dom->children){
+			result += c ? c->id : std::string("0");
+		}
+		tst::check_eq(result, std::string("00b00"), SL);
+	});
 });
 }
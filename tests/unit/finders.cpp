@@ -33,6 +33,12 @@ tst::set set("finders", [](auto& suite){
 		}
 
 		tst::check(finder_by_id.find("non_existing_id") == nullptr, SL);
+
+		// the finder keeps its own copy of the ids
+		auto e = finder_by_id.find("id1");
+		f.dom->children.front()->id = "a_much_longer_id_which_does_not_fit_into_small_string_buffer";
+		tst::check(finder_by_id.find("id1") == e, SL);
+		tst::check(finder_by_id.find("a_much_longer_id_which_does_not_fit_into_small_string_buffer") == nullptr, SL);
 	});
 
 	suite.add("finder_by_class", [](){
@@ -54,6 +60,42 @@ tst::set set("finders", [](auto& suite){
 		}
 
 		tst::check(finder_by_class_name.find("non_existent_class").empty(), SL);
+
+		// the finder keeps its own copy of the class names
+		auto e = finder_by_class_name.find("class1").front();
+		svgdom::cast_to_styleable(f.dom->children.front().get())->classes.clear();
+		tst::check(finder_by_class_name.find("class1").size() == 1, SL);
+		tst::check(finder_by_class_name.find("class1").front() == e, SL);
+	});
+
+	suite.add("finder_by_class_indexes_all_styleable_elements", [](){
+		auto dom = svgdom::load(std::string(R"qwertyuiop(
+			<svg xmlns="http://www.w3.org/2000/svg">
+				<mask class="c m"/>
+				<text class="c t"/>
+				<filter class="c f">
+					<feColorMatrix class="c fcm"/>
+					<feBlend class="c fb"/>
+					<feComposite class="c fc"/>
+				</filter>
+			</svg>
+		)qwertyuiop"));
+		tst::check(dom != nullptr, SL);
+
+		svgdom::finder_by_class finder(*dom);
+
+		// elements of class "c" go in document order
+		auto all = finder.find("c");
+		tst::check_eq(all.size(), size_t(6), SL);
+
+		std::vector<std::string> expected_tags = {"mask", "text", "filter", "feColorMatrix", "feBlend", "feComposite"};
+		for(size_t i = 0; i != expected_tags.size(); ++i){
+			tst::check_eq(all[i]->get_tag(), expected_tags[i], SL);
+		}
+
+		for(const auto& cls : {"m", "t", "f", "fcm", "fb", "fc"}){
+			tst::check_eq(finder.find(cls).size(), size_t(1), SL) << "class = " << cls;
+		}
 	});
 
 	suite.add("finder_by_tag", [](){
@@ -2,10 +2,17 @@
 #include <tst/check.hpp>
 
 #include <fstream>
+#include <sstream>
+#include <thread>
 
 #include <papki/fs_file.hpp>
+#include <papki/span_file.hpp>
 
 #include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/util/finder_by_id.hpp"
+#include "../../src/svgdom/util/binary_writer.hpp"
+#include "../../src/svgdom/util/binary_reader.hpp"
 
 namespace{
 tst::set set("misc", [](tst::suite& suite){
@@ -26,5 +33,613 @@ tst::set set("misc", [](tst::suite& suite){
             tst::check(dom, SL);
         }
     );
+
+    suite.add(
+        "all_load_paths_give_same_document",
+        [](){
+            // file is bigger than a read chunk
+            auto file_name = "samples_data/car.svg";
+
+            auto data = papki::fs_file(file_name).load();
+
+            auto expected = svgdom::load(utki::make_span(data))->to_string();
+
+            // memory mapped file
+            tst::check_eq(svgdom::load(papki::fs_file(file_name))->to_string(), expected, SL);
+
+            // generic papki::file
+            tst::check_eq(svgdom::load(papki::span_file(utki::make_span(data)))->to_string(), expected, SL);
+
+            std::ifstream ist;
+            ist.open(file_name);
+            tst::check_eq(svgdom::load(ist)->to_string(), expected, SL);
+        }
+    );
+
+    suite.add(
+        "path_data_number_formats",
+        [](){
+            auto path = svgdom::path_element::parse("M1e2-.5.5+3 l-1.5E-1,0.0025L 123456789 0.1 h5e a1 2 0 1 0 3,4 z");
+            tst::check_eq(path.size(), size_t(5), SL);
+
+            tst::check(path[0].type_ == svgdom::path_element::step::type::move_abs, SL);
+            tst::check_eq(path[0].x, svgdom::real(100), SL);
+            tst::check_eq(path[0].y, svgdom::real(-0.5), SL);
+
+            // implicit lineto after moveto
+            tst::check(path[1].type_ == svgdom::path_element::step::type::line_abs, SL);
+            tst::check_eq(path[1].x, svgdom::real(0.5), SL);
+            tst::check_eq(path[1].y, svgdom::real(3), SL);
+
+            tst::check(path[2].type_ == svgdom::path_element::step::type::line_rel, SL);
+            tst::check_eq(path[2].x, svgdom::real(-0.15), SL);
+            tst::check_eq(path[2].y, svgdom::real(0.0025), SL);
+
+            tst::check_eq(path[3].x, svgdom::real(123456789), SL);
+            tst::check_eq(path[3].y, svgdom::real(0.1), SL);
+
+            // 'e' without digits is not a part of the number, so the rest of the path is malformed and ignored
+            tst::check(path[4].type_ == svgdom::path_element::step::type::horizontal_line_rel, SL);
+            tst::check_eq(path[4].x, svgdom::real(5), SL);
+        }
+    );
+
+    suite.add(
+        "compact_path",
+        [](){
+            auto str = "M1,2 L3,4 H5 V6 C7,8 9,10 11,12 S13,14 15,16 Q17,18 19,20 T21,22 A23,24 25 1,0 26,27 a28,29 30 0,1 31,32 Z m1,1 l2,2 h3 v4 c5,6 7,8 9,10 s11,12 13,14 q15,16 17,18 t19,20 z";
+
+            svgdom::path_element expected;
+            expected.path = svgdom::path_element::parse(str);
+            tst::check_eq(expected.path.size(), size_t(20), SL);
+
+            auto compact = svgdom::compact_path::parse(str);
+            tst::check_eq(compact.size(), expected.path.size(), SL);
+            tst::check_eq(compact.get_coordinates().size(), size_t(2 + 2 + 1 + 1 + 6 + 4 + 4 + 2 + 5 + 5 + 2 + 2 + 1 + 1 + 6 + 4 + 4 + 2), SL);
+
+            svgdom::path_element unpacked;
+            unpacked.path = compact.to_steps();
+            tst::check_eq(unpacked.path_to_string(), expected.path_to_string(), SL);
+
+            svgdom::compact_path converted(expected.path);
+            auto i = converted.begin();
+            for(const auto& s : expected.path){
+                tst::check(i != converted.end(), SL);
+                tst::check((*i).type_ == s.type_, SL);
+                ++i;
+            }
+            tst::check(i == converted.end(), SL);
+
+            unpacked.path = converted.to_steps();
+            tst::check_eq(unpacked.path_to_string(), expected.path_to_string(), SL);
+
+            // arc flags are packed into command byte
+            auto arc = compact.to_steps()[9];
+            tst::check(arc.type_ == svgdom::path_element::step::type::arc_rel, SL);
+            tst::check(!arc.flags.large_arc, SL);
+            tst::check(arc.flags.sweep, SL);
+            tst::check_eq(arc.x_axis_rotation, svgdom::real(30), SL);
+        }
+    );
+
+    suite.add(
+        "style_map",
+        [](){
+            svgdom::style_map m;
+            tst::check(m.empty(), SL);
+
+            m[svgdom::style_property::stroke] = svgdom::make_style_value(1, 2, 3);
+            m[svgdom::style_property::writing_mode] = svgdom::style_value(std::string("lr"));
+            m[svgdom::style_property::color] = svgdom::make_style_value(4, 5, 6);
+            auto res = m.insert(std::make_pair(svgdom::style_property::fill, svgdom::style_value(svgdom::real(1))));
+            tst::check(res.second, SL);
+
+            // existing value is not overwritten by insert()
+            res = m.insert(std::make_pair(svgdom::style_property::color, svgdom::style_value(svgdom::real(1))));
+            tst::check(!res.second, SL);
+            tst::check(std::holds_alternative<uint32_t>(res.first->second), SL);
+
+            tst::check_eq(m.size(), size_t(4), SL);
+
+            // iteration goes in order of properties
+            std::vector<svgdom::style_property> order;
+            for(const auto& v : m){
+                order.push_back(v.first);
+            }
+            tst::check(order == decltype(order){
+                    svgdom::style_property::color,
+                    svgdom::style_property::fill,
+                    svgdom::style_property::stroke,
+                    svgdom::style_property::writing_mode
+                }, SL);
+
+            tst::check(m.find(svgdom::style_property::opacity) == m.end(), SL);
+            tst::check_eq(m.count(svgdom::style_property::opacity), size_t(0), SL);
+
+            auto i = m.find(svgdom::style_property::stroke);
+            tst::check(i != m.end(), SL);
+            tst::check(i->first == svgdom::style_property::stroke, SL);
+            tst::check(svgdom::get_rgb(i->second) == svgdom::get_rgb(svgdom::make_style_value(1, 2, 3)), SL);
+
+            tst::check_eq(m.erase(svgdom::style_property::fill), size_t(1), SL);
+            tst::check_eq(m.erase(svgdom::style_property::fill), size_t(0), SL);
+            tst::check_eq(m.size(), size_t(3), SL);
+
+            // index of the following properties is updated after erasing
+            i = m.find(svgdom::style_property::writing_mode);
+            tst::check(i != m.end(), SL);
+            tst::check_eq(std::get<std::string>(i->second), std::string("lr"), SL);
+
+            m.clear();
+            tst::check(m.empty(), SL);
+            tst::check(m.find(svgdom::style_property::stroke) == m.end(), SL);
+        }
+    );
+
+    suite.add(
+        "namespace_prefixed_attributes",
+        [](){
+            auto dom = svgdom::load(std::string(R"qwertyuiop(
+                <s:svg xmlns:s="http://www.w3.org/2000/svg" xmlns:xl="http://www.w3.org/1999/xlink" s:width="10">
+                    <s:rect s:id="r" s:width="20" fill="red" xlink:href="#ignored"/>
+                    <s:use s:id="u" xl:href="#r"/>
+                </s:svg>
+            )qwertyuiop"));
+            tst::check(dom, SL);
+            tst::check_eq(dom->width.value, svgdom::real(10), SL);
+
+            svgdom::finder_by_id finder(*dom);
+
+            auto r = dynamic_cast<const svgdom::rect_element*>(finder.find("r"));
+            tst::check(r, SL);
+            tst::check_eq(r->width.value, svgdom::real(20), SL);
+            tst::check(r->presentation_attributes.empty(), SL) << "unprefixed attribute is not in the default namespace";
+
+            auto u = dynamic_cast<const svgdom::use_element*>(finder.find("u"));
+            tst::check(u, SL);
+            tst::check_eq(u->iri, std::string("#r"), SL);
+        }
+    );
+
+    suite.add(
+        "binary_round_trip_all_element_types",
+        [](){
+            auto svg = R"qwertyuiop(
+                <svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink"
+                        width="100" height="10%" viewBox="0 0 100 100" preserveAspectRatio="xMidYMax slice"
+                        enable-background="new 0 0 10 20">
+                    <style>rect.a { fill: #ff0000; stroke-dasharray: 1 2 3; }</style>
+                    <defs transform="skewX(10) skewY(5)">
+                        <linearGradient id="lg" x1="1" y1="2%" x2="3mm" y2="4in" spreadMethod="reflect" gradientUnits="userSpaceOnUse" xlink:href="#rg">
+                            <stop offset="0.5" stop-color="blue" stop-opacity="0.3"/>
+                        </linearGradient>
+                        <radialGradient id="rg" cx="1" cy="2" r="3" fx="4" fy="5" gradientTransform="rotate(30 1 2)"/>
+                        <filter id="f" x="1" y="2" width="3" height="4" filterUnits="userSpaceOnUse" primitiveUnits="objectBoundingBox">
+                            <feGaussianBlur in="SourceGraphic" stdDeviation="2 3" result="blur"/>
+                            <feColorMatrix in="blur" type="saturate" values="0.5"/>
+                            <feBlend in="a" in2="b" mode="multiply"/>
+                            <feComposite in="a" in2="b" operator="arithmetic" k1="1" k2="2" k3="3" k4="4"/>
+                        </filter>
+                        <mask id="m" maskUnits="userSpaceOnUse" maskContentUnits="objectBoundingBox">
+                            <rect class="a b" x="1" y="2" width="3" height="4" rx="5" ry="6"/>
+                        </mask>
+                        <symbol id="s" viewBox="1 2 3 4" preserveAspectRatio="none">
+                            <circle cx="1" cy="2" r="3" style="fill: inherit; visibility: hidden"/>
+                        </symbol>
+                    </defs>
+                    <g transform="matrix(1 2 3 4 5 6) translate(1 2) scale(3)" opacity="0.5" display="none">
+                        <path d="M1 2 L3 4 H5 V6 C1 2 3 4 5 6 S1 2 3 4 Q1 2 3 4 T5 6 A1 2 3 1 0 4 5 a1 2 3 0 1 4 5 z m1 1 l1 1 h1 v1 c1 1 1 1 1 1 s1 1 1 1 q1 1 1 1 t1 1 Z"
+                                fill-rule="evenodd" stroke-linecap="round" stroke-linejoin="bevel" color-interpolation-filters="linearRGB"/>
+                        <polyline points="1 2 3 4 5 6"/>
+                        <polygon points="1,2 3,4 5,6" stroke-width="2mm"/>
+                        <ellipse cx="1" cy="2" rx="3" ry="4" fill="url(#lg)"/>
+                        <line x1="1" y1="2" x2="3" y2="4" stroke="currentColor"/>
+                        <use xlink:href="#s" x="1" y="2" width="3" height="4" transform="rotate(45)"/>
+                        <image xlink:href="image.png" x="1" y="2" width="3" height="4" preserveAspectRatio="defer xMinYMin meet"/>
+                        <text id="t" transform="scale(1 2)"/>
+                    </g>
+                </svg>
+            )qwertyuiop";
+
+            auto dom = svgdom::load(papki::span_file(utki::make_span(svg, strlen(svg))));
+            tst::check(dom, SL);
+
+            std::stringstream ss;
+            {
+                svgdom::binary_writer w(ss);
+                dom->accept(w);
+            }
+            auto bin = ss.str();
+
+            auto read_dom = svgdom::binary_reader(utki::make_span(reinterpret_cast<const uint8_t*>(bin.data()), bin.size())).read_svg();
+            tst::check(read_dom, SL);
+            tst::check_eq(read_dom->to_string(), dom->to_string(), SL);
+
+            // make sure the test document is not silently truncated by the parser
+            tst::check(dom->to_string().find("feComposite") != std::string::npos, SL);
+            tst::check(dom->to_string().find("image.png") != std::string::npos, SL);
+        }
+    );
+
+    suite.add(
+        "binary_reader_rejects_bad_header",
+        [](){
+            for(std::string data : {std::string(), std::string("SVG"), std::string("XXXX\x02\x04"), std::string("SVGB\x01\x04"), std::string("SVGB\x03\x04"), std::string("SVGB\x02\x03")}){
+                bool thrown = false;
+                try{
+                    svgdom::binary_reader r(utki::make_span(reinterpret_cast<const uint8_t*>(data.data()), data.size()));
+                }catch(std::invalid_argument&){
+                    thrown = true;
+                }
+                tst::check(thrown, SL) << "data = " << data;
+            }
+        }
+    );
+
+    suite.add(
+        "binary_reader_rejects_trailing_data",
+        [](){
+            svgdom::svg_element svg;
+
+            std::stringstream ss;
+            {
+                svgdom::binary_writer w(ss);
+                svg.accept(w);
+            }
+            auto bin = ss.str();
+
+            // the data written is read back without errors
+            tst::check(svgdom::binary_reader(utki::make_span(reinterpret_cast<const uint8_t*>(bin.data()), bin.size())).read_svg(), SL);
+
+            for(std::string trailing : {std::string(1, '\0'), std::string("garbage"), bin}){
+                auto data = bin + trailing;
+                bool thrown = false;
+                try{
+                    svgdom::binary_reader(utki::make_span(reinterpret_cast<const uint8_t*>(data.data()), data.size())).read_svg();
+                }catch(std::invalid_argument&){
+                    thrown = true;
+                }
+                tst::check(thrown, SL) << "trailing.size() = " << trailing.size();
+            }
+        }
+    );
+
+    suite.add(
+        "binary_reader_rejects_malformed_path",
+        [](){
+            auto svg = std::string(R"(<svg xmlns="http://www.w3.org/2000/svg"><path d="M1 2 L3 4 L5 6 Z"/></svg>)");
+            auto dom = svgdom::load(svg);
+            tst::check(dom, SL);
+
+            std::stringstream ss;
+            {
+                svgdom::binary_writer w(ss);
+                dom->accept(w);
+            }
+            auto bin = ss.str();
+
+            // number of commands followed by move_abs, 2 line_abs and close commands
+            auto commands = std::string("\x04\x02\x04\x04\x01");
+            auto pos = bin.find(commands);
+            tst::check(pos != std::string::npos, SL);
+            tst::check(bin.find(commands, pos + 1) == std::string::npos, SL);
+
+            // the data written is read back without errors
+            tst::check(svgdom::binary_reader(utki::make_span(reinterpret_cast<const uint8_t*>(bin.data()), bin.size())).read_svg(), SL);
+
+            // replace the close command, which has no coordinates, so that the number of coordinates still matches
+            for(char command : {
+                    char(svgdom::path_element::step::type::unknown),
+                    char(unsigned(svgdom::path_element::step::type::arc_rel) + 1),
+                    char(unsigned(svgdom::path_element::step::type::close) | 0x20) // arc flag for non-arc command
+                })
+            {
+                auto data = bin;
+                data[pos + 4] = command;
+                bool thrown = false;
+                try{
+                    svgdom::binary_reader(utki::make_span(reinterpret_cast<const uint8_t*>(data.data()), data.size())).read_svg();
+                }catch(std::invalid_argument&){
+                    thrown = true;
+                }
+                tst::check(thrown, SL) << "command = " << unsigned(command);
+            }
+        }
+    );
+
+    suite.add(
+        "binary_text_positioning_is_not_stored",
+        [](){
+            // text_positioning attributes x, y, dx, dy and rotate are not supported yet,
+            // neither parser nor writers keep them, so text elements round trip without them
+            const char* svg = R"qwertyuiop(
+                <svg xmlns="http://www.w3.org/2000/svg">
+                    <text id="t" x="1" y="2" dx="3" dy="4" rotate="5" fill="red"/>
+                </svg>
+            )qwertyuiop";
+
+            auto dom = svgdom::load(papki::span_file(utki::make_span(svg, strlen(svg))));
+            tst::check(dom, SL);
+
+            std::stringstream ss;
+            {
+                svgdom::binary_writer w(ss);
+                dom->accept(w);
+            }
+            auto bin = ss.str();
+
+            auto read_dom = svgdom::binary_reader(utki::make_span(reinterpret_cast<const uint8_t*>(bin.data()), bin.size())).read_svg();
+            tst::check(read_dom, SL);
+
+            auto str = read_dom->to_string();
+            tst::check_eq(str, dom->to_string(), SL);
+            tst::check(str.find("<text id=\"t\"") != std::string::npos, SL) << str;
+            tst::check(str.find("fill") != std::string::npos, SL) << str;
+            tst::check(str.find("rotate") == std::string::npos, SL) << str;
+            tst::check(str.find("dx") == std::string::npos, SL) << str;
+        }
+    );
+
+    suite.add(
+        "binary_writes_repeated_strings_once",
+        [](){
+            std::stringstream ss;
+            ss << R"(<svg xmlns="http://www.w3.org/2000/svg">)";
+            for(unsigned i = 0; i != 100; ++i){
+                ss << R"(<rect class="repeated_class_name" width="1" height="1"/>)";
+            }
+            ss << "</svg>";
+            auto svg = ss.str();
+
+            auto dom = svgdom::load(papki::span_file(utki::make_span(svg.data(), svg.size())));
+            tst::check(dom, SL);
+
+            std::stringstream bs;
+            {
+                svgdom::binary_writer w(bs);
+                dom->accept(w);
+            }
+            auto bin = bs.str();
+
+            auto first = bin.find("repeated_class_name");
+            tst::check(first != std::string::npos, SL);
+            tst::check(bin.find("repeated_class_name", first + 1) == std::string::npos, SL);
+
+            auto read_dom = svgdom::binary_reader(utki::make_span(reinterpret_cast<const uint8_t*>(bin.data()), bin.size())).read_svg();
+            tst::check(read_dom, SL);
+            tst::check_eq(read_dom->to_string(), dom->to_string(), SL);
+        }
+    );
+
+    suite.add(
+        "load_stats",
+        [](){
+            const std::string svg = R"(<svg xmlns="http://www.w3.org/2000/svg">
+                <style>rect{fill:red}</style>
+                <g>
+                    <path d="M 0 0 L 10 10 z" style="fill:red;stroke:blue" stroke-width="2"/>
+                    <path d="M 1 1 h 5"/>
+                    <unknown_element/>
+                </g>
+            </svg>)";
+
+            svgdom::load_stats stats;
+            svgdom::load_options options;
+            options.stats = &stats;
+
+            // statistics left from elsewhere are reset on load, also if they are not gathered
+            stats.num_elements = 100;
+            stats.time.total = 100;
+            stats.elements_per_tag["garbage"] = 100;
+
+            auto dom = svgdom::load(svg, options);
+            tst::check(dom, SL);
+
+            if(!SVGDOM_STATS){
+                tst::check_eq(stats.num_elements, size_t(0), SL);
+                tst::check_eq(stats.time.total, uint64_t(0), SL);
+                tst::check(stats.elements_per_tag.empty(), SL);
+                return;
+            }
+
+            tst::check(stats.elements_per_tag.find("garbage") == stats.elements_per_tag.end(), SL);
+
+            tst::check_eq(stats.num_elements, size_t(5), SL);
+            tst::check_eq(stats.elements_per_tag.size(), size_t(4), SL);
+            tst::check_eq(stats.elements_per_tag["path"], size_t(2), SL);
+            tst::check_eq(stats.elements_per_tag["svg"], size_t(1), SL);
+            tst::check_eq(stats.num_unknown_elements, size_t(1), SL);
+            tst::check_eq(stats.path_data_bytes, std::string("M 0 0 L 10 10 z").size() + std::string("M 1 1 h 5").size(), SL);
+            tst::check_eq(stats.num_path_steps, size_t(5), SL);
+            tst::check_eq(stats.num_style_properties, size_t(3), SL);
+            tst::check_eq(stats.num_element_allocations, size_t(5), SL);
+
+            const auto& t = stats.time;
+            tst::check(t.total != 0, SL);
+            tst::check_eq(t.xml + t.elements + t.css, t.total, SL);
+            tst::check_le(t.path_data + t.styles, t.elements, SL);
+
+            // statistics are reset on next load
+            options.lazy_parsing = true;
+            options.use_arena = true;
+            dom = svgdom::load(svg, options);
+            tst::check(dom, SL);
+            tst::check_eq(stats.num_elements, size_t(5), SL);
+            tst::check_eq(stats.elements_per_tag["path"], size_t(2), SL);
+            tst::check_eq(stats.num_path_steps, size_t(0), SL);
+            tst::check_eq(stats.num_style_properties, size_t(0), SL);
+            // one arena block and the root element
+            tst::check_eq(stats.num_element_allocations, size_t(2), SL);
+            tst::check(stats.path_data_bytes != 0, SL);
+
+            // load_all() gathers statistics per document
+            std::vector<utki::span<const char>> bufs = {utki::make_span(svg), utki::make_span(svg)};
+            options = svgdom::load_options();
+            options.stats = &stats;
+            stats = svgdom::load_stats();
+            auto results = svgdom::load_all(utki::make_span(bufs), 2, options);
+            tst::check_eq(results.size(), size_t(2), SL);
+            for(const auto& r : results){
+                tst::check(r.dom, SL);
+                tst::check_eq(r.stats.num_elements, size_t(5), SL);
+            }
+            tst::check_eq(stats.num_elements, size_t(0), SL);
+        }
+    );
+
+    suite.add(
+        "lazy_parsing_edit",
+        [](){
+            svgdom::load_options options;
+            options.lazy_parsing = true;
+
+            auto dom = svgdom::load(std::string(R"qwertyuiop(
+                <svg xmlns="http://www.w3.org/2000/svg">
+                    <path d="M1,2 L3,4" style="fill:red" stroke="blue"/>
+                    <polygon points="1,2 3,4"/>
+                </svg>
+            )qwertyuiop"), options);
+            tst::check(dom, SL);
+
+            tst::check_eq(dom->children.size(), size_t(2), SL);
+
+            auto p = dynamic_cast<svgdom::path_element*>(dom->children.front().get());
+            tst::check(p, SL);
+            auto pg = dynamic_cast<svgdom::polygon_element*>(dom->children.back().get());
+            tst::check(pg, SL);
+
+            // nothing is parsed until parse_deferred() is called
+            tst::check(p->deferred, SL);
+            tst::check(p->path.empty(), SL);
+            tst::check(p->styles.empty(), SL);
+            tst::check(p->presentation_attributes.empty(), SL);
+            tst::check(pg->deferred, SL);
+            tst::check(pg->points.empty(), SL);
+
+            // values set before parsing take precedence over the deferred text
+            p->presentation_attributes[svgdom::style_property::stroke] = svgdom::make_style_value(0, 0xff, 0);
+
+            auto str = dom->to_string();
+            tst::check(str.find(R"(d="M1,2 L3,4")") != std::string::npos, SL) << "str = " << str;
+            tst::check(str.find(R"(style="fill:red")") != std::string::npos, SL) << "str = " << str;
+            tst::check(str.find(R"(stroke="lime")") != std::string::npos, SL) << "str = " << str;
+            tst::check(str.find(R"(points="1,2,3,4")") != std::string::npos, SL) << "str = " << str;
+
+            // writing does not modify the elements
+            tst::check(p->deferred, SL);
+            tst::check(p->path.empty(), SL);
+
+            p->parse_deferred();
+            pg->parse_deferred();
+            tst::check(!p->deferred, SL);
+            tst::check(!pg->deferred, SL);
+            tst::check_eq(p->path.size(), size_t(2), SL);
+            tst::check_eq(p->styles.size(), size_t(1), SL);
+            tst::check_eq(p->presentation_attributes.size(), size_t(1), SL);
+            tst::check_eq(pg->points.size(), size_t(2), SL);
+            tst::check_eq(dom->to_string(), str, SL);
+
+            // once parsed, modifications of the members are not overwritten
+            p->path.clear();
+            p->styles.clear();
+            pg->points.clear();
+
+            str = dom->to_string();
+            tst::check(str.find("d=") == std::string::npos, SL) << "str = " << str;
+            tst::check(str.find("style=") == std::string::npos, SL) << "str = " << str;
+            tst::check(str.find("points=") == std::string::npos, SL) << "str = " << str;
+            tst::check(str.find(R"(stroke="lime")") != std::string::npos, SL) << "str = " << str;
+        }
+    );
+
+    suite.add(
+        "lazy_parsing_concurrent_write",
+        [](){
+            auto svg = std::string(R"qwertyuiop(
+                <svg xmlns="http://www.w3.org/2000/svg">
+                    <path d="M1,2 L3,4 L5,6" style="fill:red;stroke:blue" opacity="0.5"/>
+                </svg>
+            )qwertyuiop");
+
+            auto expected = svgdom::load(svg)->to_string();
+
+            svgdom::load_options options;
+            options.lazy_parsing = true;
+
+            std::shared_ptr<const svgdom::svg_element> dom = svgdom::load(svg, options);
+            tst::check(dom, SL);
+
+            // writers do not modify the elements, so a lazily loaded document can be written from several threads
+            std::vector<std::thread> threads;
+            std::vector<std::string> strs(4);
+            for(auto& s : strs){
+                threads.emplace_back([&dom, &s](){
+                    s = dom->to_string();
+                });
+            }
+            for(auto& t : threads){
+                t.join();
+            }
+
+            for(const auto& s : strs){
+                tst::check_eq(s, expected, SL);
+            }
+        }
+    );
+
+    suite.add(
+        "arena_and_heap_elements",
+        [](){
+            svgdom::load_options options;
+            options.use_arena = true;
+
+            auto dom = svgdom::load(std::string(R"qwertyuiop(
+                <svg xmlns="http://www.w3.org/2000/svg">
+                    <rect width="1" height="2"/>
+                    <circle r="3"/>
+                </svg>
+            )qwertyuiop"), options);
+            tst::check(dom, SL);
+            tst::check_eq(dom->children.size(), size_t(2), SL);
+
+            // heap allocated elements can be mixed with the arena allocated ones
+            auto heap_element = std::make_unique<svgdom::g_element>();
+            heap_element->children.push_back(std::move(dom->children.back()));
+            dom->children.pop_back();
+            dom->children.push_back(std::move(heap_element));
+            dom->children.push_back(std::make_unique<svgdom::circle_element>());
+
+            tst::check_eq(dom->children.size(), size_t(3), SL);
+
+            dom->children.erase(dom->children.begin());
+
+            auto str = dom->to_string();
+            tst::check(str.find("<rect") == std::string::npos, SL) << "str = " << str;
+            tst::check(str.find("<g>") != std::string::npos, SL) << "str = " << str;
+        }
+    );
+
+    suite.add(
+        "arena_document_in_unknown_element",
+        [](){
+            // the 'svg' element is not the root, so it is ignored along with its children
+            const std::string svg = R"qwertyuiop(<x:doc xmlns:x="urn:x"><svg xmlns="http://www.w3.org/2000/svg"><rect/><g><circle/></g></svg></x:doc>)qwertyuiop";
+
+            auto load = [&svg](bool use_arena) -> std::string{
+                svgdom::load_stats stats;
+                svgdom::load_options options;
+                options.use_arena = use_arena;
+                options.stats = &stats;
+                try{
+                    auto dom = svgdom::load(svg, options);
+                    return dom ? dom->to_string() : std::string("nullptr");
+                }catch(std::exception& e){
+                    return std::string("exception: ") + e.what();
+                }
+            };
+
+            tst::check_eq(load(true), load(false), SL);
+        }
+    );
 });
-}
+}
\ No newline at end of file
@@ -5,16 +5,301 @@
 #include <papki/vector_file.hpp>
 
 #include <utki/linq.hpp>
+#include <utki/string.hpp>
 
 #include <regex>
 #include <clocale>
+#include <sstream>
+#include <functional>
 
 #include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/stream_parser.hpp"
+#include "../../src/svgdom/incremental_loader.hpp"
+#include "../../src/svgdom/util/binary_writer.hpp"
+#include "../../src/svgdom/util/binary_reader.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/util/traversal.hpp"
+#include "../../src/svgdom/util/parallel_writer.hpp"
 
 namespace{
 const std::string data_dir = "samples_data/";
 }
 
+namespace{
+// makes description of elements in the order they are closed
+class post_order_describer : public svgdom::const_visitor{
+	size_t depth = 0;
+public:
+	std::vector<std::string> descriptions;
+
+	static std::string describe(const svgdom::element& e, size_t depth){
+		auto ret = std::to_string(depth) + " " + e.get_tag() + " " + e.id;
+		if(!dynamic_cast<const svgdom::container*>(&e)){
+			ret += " " + e.to_string();
+		}
+		return ret;
+	}
+
+	void default_visit(const svgdom::element& e)override{
+		this->descriptions.push_back(describe(e, this->depth));
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		++this->depth;
+		this->relay_accept(c);
+		--this->depth;
+		this->descriptions.push_back(describe(e, this->depth));
+	}
+};
+}
+
+namespace{
+// absolute end points of all path steps, as path data consumers resolve them
+std::vector<svgdom::real> path_end_points(const svgdom::path_element& e){
+	using step = svgdom::path_element::step;
+
+	std::vector<svgdom::real> ret;
+
+	svgdom::real x = 0;
+	svgdom::real y = 0;
+	svgdom::real subpath_x = 0;
+	svgdom::real subpath_y = 0;
+
+	for(auto& s : e.path){
+		bool is_relative = std::islower(step::type_to_char(s.type_));
+		switch(s.type_){
+			case step::type::close:
+				x = subpath_x;
+				y = subpath_y;
+				break;
+			case step::type::horizontal_line_abs:
+			case step::type::horizontal_line_rel:
+				x = is_relative ? x + s.x : s.x;
+				break;
+			case step::type::vertical_line_abs:
+			case step::type::vertical_line_rel:
+				y = is_relative ? y + s.y : s.y;
+				break;
+			default:
+				x = is_relative ? x + s.x : s.x;
+				y = is_relative ? y + s.y : s.y;
+				break;
+		}
+		if(s.type_ == step::type::move_abs || s.type_ == step::type::move_rel){
+			subpath_x = x;
+			subpath_y = y;
+		}
+		ret.push_back(x);
+		ret.push_back(y);
+	}
+
+	return ret;
+}
+}
+
+namespace{
+// Path data parser as it was before the dedicated path tokenizer, built on utki::string_parser.
+// It serves as a reference for correctness of path_element::parse().
+decltype(svgdom::path_element::path) reference_parse_path(std::string_view str){
+	using step = svgdom::path_element::step;
+	using svgdom::real;
+
+	decltype(svgdom::path_element::path) ret;
+
+	try{
+		utki::string_parser p(str);
+
+		p.skip_whitespaces();
+
+		step::type cur_step_type = step::type::unknown;
+
+		while(!p.empty()){
+			{
+				auto t = step::char_to_type(p.peek_char());
+				if(t != step::type::unknown){
+					cur_step_type = t;
+					p.read_char();
+				}else if(cur_step_type == step::type::unknown){
+					cur_step_type = step::type::move_abs;
+				}else if(cur_step_type == step::type::move_abs){
+					cur_step_type = step::type::line_abs;
+				}else if(cur_step_type == step::type::move_rel){
+					cur_step_type = step::type::line_rel;
+				}
+			}
+
+			p.skip_whitespaces();
+
+			step cur_step;
+			cur_step.type_ = cur_step_type;
+
+			auto next = [&p](){
+				p.skip_whitespaces_and_comma();
+				return p.read_number<real>();
+			};
+
+			switch(cur_step.type_){
+				case step::type::move_abs:
+				case step::type::move_rel:
+				case step::type::line_abs:
+				case step::type::line_rel:
+				case step::type::quadratic_smooth_abs:
+				case step::type::quadratic_smooth_rel:
+					cur_step.x = p.read_number<real>();
+					cur_step.y = next();
+					break;
+				case step::type::horizontal_line_abs:
+				case step::type::horizontal_line_rel:
+					cur_step.x = p.read_number<real>();
+					break;
+				case step::type::vertical_line_abs:
+				case step::type::vertical_line_rel:
+					cur_step.y = p.read_number<real>();
+					break;
+				case step::type::cubic_abs:
+				case step::type::cubic_rel:
+					cur_step.x1 = p.read_number<real>();
+					cur_step.y1 = next();
+					cur_step.x2 = next();
+					cur_step.y2 = next();
+					cur_step.x = next();
+					cur_step.y = next();
+					break;
+				case step::type::cubic_smooth_abs:
+				case step::type::cubic_smooth_rel:
+					cur_step.x2 = p.read_number<real>();
+					cur_step.y2 = next();
+					cur_step.x = next();
+					cur_step.y = next();
+					break;
+				case step::type::quadratic_abs:
+				case step::type::quadratic_rel:
+					cur_step.x1 = p.read_number<real>();
+					cur_step.y1 = next();
+					cur_step.x = next();
+					cur_step.y = next();
+					break;
+				case step::type::arc_abs:
+				case step::type::arc_rel:
+					cur_step.rx = p.read_number<real>();
+					cur_step.ry = next();
+					cur_step.x_axis_rotation = next();
+					p.skip_whitespaces_and_comma();
+					cur_step.flags.large_arc = (p.read_char() != '0');
+					p.skip_whitespaces_and_comma();
+					cur_step.flags.sweep = (p.read_char() != '0');
+					cur_step.x = next();
+					cur_step.y = next();
+					break;
+				default:
+					break;
+			}
+
+			ret.push_back(cur_step);
+
+			p.skip_whitespaces_and_comma();
+		}
+	}catch(std::invalid_argument&){}
+
+	return ret;
+}
+
+// extracts values of all 'd' attributes from the SVG file text
+std::vector<std::string> extract_path_data(const std::vector<uint8_t>& svg){
+	std::string_view s(reinterpret_cast<const char*>(svg.data()), svg.size());
+
+	std::vector<std::string> ret;
+
+	const std::string_view d_attr = "d=\"";
+	for(auto pos = s.find(d_attr); pos != std::string_view::npos; pos = s.find(d_attr, pos)){
+		bool is_attr_start = pos != 0 && utki::string_parser::is_space(s[pos - 1]);
+		pos += d_attr.size();
+		auto end = s.find('"', pos);
+		if(end == std::string_view::npos){
+			break;
+		}
+		if(is_attr_start){
+			ret.emplace_back(s.substr(pos, end - pos));
+		}
+		pos = end;
+	}
+
+	return ret;
+}
+}
+
+namespace{
+std::string to_binary(const svgdom::element& e){
+    std::stringstream ss;
+    {
+        svgdom::binary_writer w(ss);
+        e.accept(w);
+    }
+    return ss.str();
+}
+
+std::unique_ptr<svgdom::svg_element> load_with(const std::vector<uint8_t>& data, void (*setup)(svgdom::load_options&)){
+    svgdom::load_options options;
+    setup(options);
+    auto dom = svgdom::load(utki::make_span(data), options);
+    tst::check(dom, SL);
+    return dom;
+}
+
+// Ways of loading and writing the document. Each of them must give the same text as loading
+// the document with default options and writing it with stream_writer.
+struct round_trip{
+    std::string name;
+    std::function<std::string(const std::vector<uint8_t>& data, const svgdom::write_options& options)> func;
+};
+
+const std::vector<round_trip> round_trips = {
+    {"arena", [](const auto& data, const auto& options){
+        return load_with(data, [](auto& o){o.use_arena = true;})->to_string(options);
+    }},
+    {"lazy", [](const auto& data, const auto& options){
+        return load_with(data, [](auto& o){o.lazy_parsing = true;})->to_string(options);
+    }},
+    {"arena_lazy", [](const auto& data, const auto& options){
+        return load_with(data, [](auto& o){o.use_arena = true; o.lazy_parsing = true;})->to_string(options);
+    }},
+    {"incremental", [](const auto& data, const auto& options){
+        svgdom::incremental_loader loader(data.size());
+        const size_t chunk_size = 1000;
+        for(size_t i = 0; i < data.size(); i += chunk_size){
+            loader.feed(utki::make_span(data.data() + i, std::min(chunk_size, data.size() - i)));
+        }
+        loader.end();
+        auto dom = loader.get_dom();
+        tst::check(dom, SL);
+        return dom->to_string(options);
+    }},
+    {"binary", [](const auto& data, const auto& options){
+        auto bin = to_binary(*load_with(data, [](auto&){}));
+        auto dom = svgdom::binary_reader(utki::make_span(reinterpret_cast<const uint8_t*>(bin.data()), bin.size())).read_svg();
+        tst::check(dom, SL);
+        return dom->to_string(options);
+    }},
+    // more threads than there are hardware threads to make sure the tree gets split
+    {"parallel_write_1", [](const auto& data, const auto& options){
+        return svgdom::parallel_writer::to_string(*load_with(data, [](auto&){}), options, 1);
+    }},
+    {"parallel_write_2", [](const auto& data, const auto& options){
+        return svgdom::parallel_writer::to_string(*load_with(data, [](auto&){}), options, 2);
+    }},
+    {"parallel_write_3", [](const auto& data, const auto& options){
+        return svgdom::parallel_writer::to_string(*load_with(data, [](auto&){}), options, 3);
+    }},
+    {"parallel_write_16", [](const auto& data, const auto& options){
+        return svgdom::parallel_writer::to_string(*load_with(data, [](auto&){}), options, 16);
+    }},
+    // deferred data is parsed by the threads which write the elements
+    {"lazy_parallel_write", [](const auto& data, const auto& options){
+        return svgdom::parallel_writer::to_string(*load_with(data, [](auto& o){o.lazy_parsing = true;}), options, 3);
+    }},
+};
+}
+
 namespace{
 tst::set set("samples", [](tst::suite& suite){
     // make sure the locale does not affect parsing (decimal delimiter can be "." or "," in different locales)
@@ -32,6 +317,291 @@ tst::set set("samples", [](tst::suite& suite){
                 )
             .get();
 
+    suite.add(
+        "load_all",
+        [files](){
+            std::vector<std::vector<uint8_t>> datas;
+            for(const auto& f : files){
+                datas.push_back(papki::fs_file(data_dir + f).load());
+            }
+
+            // root element is not svg
+            const std::string malformed = R"qwertyuiop(<g xmlns="http://www.w3.org/2000/svg"/>)qwertyuiop";
+
+            std::vector<utki::span<const char>> bufs;
+            for(const auto& d : datas){
+                bufs.push_back(utki::make_span(reinterpret_cast<const char*>(d.data()), d.size()));
+            }
+            bufs.push_back(utki::make_span(malformed));
+
+            auto results = svgdom::load_all(utki::make_span(bufs), 4);
+            tst::check_eq(results.size(), bufs.size(), SL);
+
+            for(size_t i = 0; i != datas.size(); ++i){
+                auto& r = results[i];
+                tst::check(!r.error, SL) << "file: " << files[i];
+                tst::check(r.dom, SL) << "file: " << files[i];
+                tst::check_eq(r.dom->to_string(), svgdom::load(utki::make_span(datas[i]))->to_string(), SL) << "file: " << files[i];
+            }
+
+            tst::check(!results.back().dom, SL);
+            tst::check(results.back().error, SL);
+        }
+    );
+
+    suite.add<std::string>(
+        "sample_round_trip",
+        std::vector<std::string>(files),
+        [](auto& p){
+            auto data = papki::fs_file(data_dir + p).load();
+
+            auto dom = svgdom::load(utki::make_span(data));
+            tst::check(dom, SL);
+
+            svgdom::write_options compact_options;
+            compact_options.compact = true;
+
+            for(const auto& options : {svgdom::write_options(), compact_options}){
+                auto expected = dom->to_string(options);
+
+                for(const auto& rt : round_trips){
+                    tst::check_eq(rt.func(data, options), expected, SL)
+                            << "file: " << p << ", round trip: " << rt.name << ", compact = " << options.compact;
+                }
+            }
+        }
+    );
+
+    suite.add<std::string>(
+        "sample_arena_erase",
+        std::vector<std::string>(files),
+        [](auto& p){
+            svgdom::load_options options;
+            options.use_arena = true;
+
+            auto dom = svgdom::load(papki::fs_file(data_dir + p), options);
+            tst::check(dom, SL);
+
+            // removing elements from arena allocated document must work
+            dom->children.clear();
+
+            // the root element keeps working
+            auto str = dom->to_string();
+            tst::check(str.find("<svg") == 0, SL) << str;
+            tst::check(str.find("/>") == str.size() - 3, SL) << str;
+        }
+    );
+
+    suite.add<std::string>(
+        "sample_stream",
+        std::vector<std::string>(files),
+        [](auto& p){
+            auto data = papki::fs_file(data_dir + p).load();
+
+            auto dom = svgdom::load(utki::make_span(data));
+            tst::check(dom, SL);
+
+            post_order_describer describer;
+            dom->accept(describer);
+
+            std::vector<std::string> streamed;
+            svgdom::stream_parser parser([&](svgdom::element& e, utki::span<const svgdom::element* const> ancestors){
+                if(auto c = dynamic_cast<const svgdom::container*>(&e)){
+                    tst::check(c->children.empty(), SL);
+                }
+                if(ancestors.empty()){
+                    tst::check(dynamic_cast<const svgdom::svg_element*>(&e), SL);
+                }
+                streamed.push_back(post_order_describer::describe(e, ancestors.size()));
+            });
+
+            // feed in small chunks to make sure elements spanning several chunks are handled
+            const size_t chunk_size = 100;
+            for(size_t i = 0; i < data.size(); i += chunk_size){
+                parser.feed(utki::make_span(data.data() + i, std::min(chunk_size, data.size() - i)));
+            }
+            parser.end();
+
+            tst::check_eq(streamed.size(), describer.descriptions.size(), SL);
+            for(size_t i = 0; i != streamed.size(); ++i){
+                tst::check_eq(streamed[i], describer.descriptions[i], SL) << "file: " << p;
+            }
+        }
+    );
+
+    suite.add<std::string>(
+        "sample_incremental_progress",
+        std::vector<std::string>(files),
+        [](auto& p){
+            auto data = papki::fs_file(data_dir + p).load();
+
+            svgdom::incremental_loader loader(data.size());
+            tst::check(!loader.peek_dom(), SL);
+
+            const size_t chunk_size = 1000;
+            for(size_t i = 0; i < data.size(); i += chunk_size){
+                loader.feed(utki::make_span(data.data() + i, std::min(chunk_size, data.size() - i)));
+
+                auto progress = loader.get_progress();
+                tst::check_eq(progress.bytes_fed, std::min(i + chunk_size, data.size()), SL);
+                tst::check_eq(progress.bytes_total, data.size(), SL);
+
+                // open elements form a chain of last children from the root down
+                auto open = loader.get_open_elements();
+                if(open.empty()){
+                    continue;
+                }
+                tst::check(open.front() == loader.peek_dom(), SL);
+                for(size_t j = 1; j < open.size(); ++j){
+                    auto c = dynamic_cast<const svgdom::container*>(open[j - 1]);
+                    tst::check(c, SL);
+                    tst::check(!c->children.empty(), SL);
+                    tst::check(c->children.back().get() == open[j], SL);
+                }
+            }
+            loader.end();
+
+            tst::check(loader.get_open_elements().empty(), SL);
+            tst::check_eq(loader.get_progress().get_ratio(), 1.0f, SL);
+
+            post_order_describer describer;
+            loader.peek_dom()->accept(describer);
+            tst::check_eq(loader.get_progress().num_elements, describer.descriptions.size(), SL);
+
+            auto dom = loader.get_dom();
+            tst::check(dom, SL);
+            tst::check(!loader.peek_dom(), SL);
+        }
+    );
+
+    suite.add<std::string>(
+        "sample_binary_data",
+        std::vector<std::string>(files),
+        [](auto& p){
+            auto dom = svgdom::load(papki::fs_file(data_dir + p));
+            tst::check(dom, SL);
+
+            auto bin = to_binary(*dom);
+            auto bin_span = utki::make_span(reinterpret_cast<const uint8_t*>(bin.data()), bin.size());
+
+            // writing the read document gives the same binary data
+            auto read_dom = svgdom::binary_reader(bin_span).read_svg();
+            tst::check(read_dom, SL);
+            tst::check(to_binary(*read_dom) == bin, SL);
+
+            // truncated data must not be accepted
+            for(size_t size = 0; size < bin.size(); size += std::max(bin.size() / 50, size_t(1))){
+                bool thrown = false;
+                try{
+                    svgdom::binary_reader(bin_span.subspan(0, size)).read();
+                }catch(std::invalid_argument&){
+                    thrown = true;
+                }
+                tst::check(thrown, SL) << "size = " << size;
+            }
+        }
+    );
+
+    suite.add<std::string>(
+        "sample_compact",
+        std::vector<std::string>(files),
+        [](auto& p){
+            auto dom = svgdom::load(papki::fs_file(data_dir + p));
+            tst::check(dom, SL);
+
+            svgdom::write_options options;
+            options.compact = true;
+
+            auto str = dom->to_string(options);
+
+            tst::check_le(str.size(), dom->to_string().size(), SL);
+
+            auto compact_dom = svgdom::load(str);
+            tst::check(compact_dom, SL);
+
+            std::vector<const svgdom::element*> elements;
+            svgdom::traversal::pre_order(*dom, [&](const svgdom::element& e){
+                elements.push_back(&e);
+            });
+
+            std::vector<const svgdom::element*> compact_elements;
+            svgdom::traversal::pre_order(*compact_dom, [&](const svgdom::element& e){
+                compact_elements.push_back(&e);
+            });
+
+            tst::check_eq(compact_elements.size(), elements.size(), SL);
+
+            for(size_t i = 0; i != elements.size(); ++i){
+                tst::check_eq(compact_elements[i]->get_tag(), elements[i]->get_tag(), SL);
+                tst::check_eq(compact_elements[i]->id, elements[i]->id, SL);
+
+                auto path = dynamic_cast<const svgdom::path_element*>(elements[i]);
+                if(!path){
+                    continue;
+                }
+
+                auto points = path_end_points(*path);
+                auto compact_points = path_end_points(dynamic_cast<const svgdom::path_element&>(*compact_elements[i]));
+                tst::check_eq(compact_points.size(), points.size(), SL);
+
+                for(size_t j = 0; j != points.size(); ++j){
+                    using std::abs;
+                    using std::max;
+                    // 6 significant digits
+                    tst::check(abs(compact_points[j] - points[j]) <= max(abs(points[j]), svgdom::real(1)) * svgdom::real(1e-5), SL)
+                            << "file: " << p << ", element: " << i << ", point: " << j
+                            << ", expected: " << points[j] << ", actual: " << compact_points[j];
+                }
+            }
+        }
+    );
+
+    suite.add<std::string>(
+        "sample_lazy_keeps_parsed_values",
+        std::vector<std::string>(files),
+        [](auto& p){
+            auto data = papki::fs_file(data_dir + p).load();
+
+            auto dom = svgdom::load(utki::make_span(data));
+            tst::check(dom, SL);
+
+            svgdom::load_options options;
+            options.lazy_parsing = true;
+
+            auto lazy_dom = svgdom::load(utki::make_span(data), options);
+            tst::check(lazy_dom, SL);
+
+            // nothing is parsed until parse_deferred() is called
+            tst::check(lazy_dom->styles.empty(), SL);
+            tst::check(lazy_dom->presentation_attributes.empty(), SL);
+
+            // parsing gives the same values as parsing while loading, and they are kept
+            lazy_dom->parse_deferred();
+            tst::check(!lazy_dom->deferred, SL);
+            tst::check_eq(lazy_dom->styles.size(), dom->styles.size(), SL);
+            tst::check_eq(lazy_dom->presentation_attributes.size(), dom->presentation_attributes.size(), SL);
+            tst::check_eq(lazy_dom->to_string(), dom->to_string(), SL);
+        }
+    );
+
+    suite.add<std::string>(
+        "path_data",
+        std::vector<std::string>(files),
+        [](auto& p){
+            auto data = extract_path_data(papki::fs_file(data_dir + p).load());
+
+            for(const auto& d : data){
+                svgdom::path_element expected;
+                expected.path = reference_parse_path(d);
+
+                svgdom::path_element parsed;
+                parsed.path = svgdom::path_element::parse(d);
+
+                tst::check_eq(parsed.path_to_string(), expected.path_to_string(), SL) << "file: " << p;
+            }
+        }
+    );
+
     suite.add<std::string>(
         "sample",
         std::move(files),
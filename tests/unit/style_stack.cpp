@@ -2,10 +2,19 @@
 #include <tst/check.hpp>
 
 #include <papki/span_file.hpp>
+#include <papki/fs_file.hpp>
+
+#include <utki/linq.hpp>
+
+#include <regex>
 
 #include "../../src/svgdom/visitor.hpp"
 #include "../../src/svgdom/util/style_stack.hpp"
+#include "../../src/svgdom/util/computed_styles.hpp"
+#include "../../src/svgdom/util/casters.hpp"
+#include "../../src/svgdom/util/finder_by_id.hpp"
 #include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/elements/style.hpp"
 
 namespace{
 auto svg = R"qwertyuiop(
@@ -85,6 +94,110 @@ public:
 };
 }
 
+namespace{
+auto inherit_svg = R"qwertyuiop(
+<svg xmlns="http://www.w3.org/2000/svg" fill="red" style="stroke: blue; opacity: 0.5">
+	<style type="text/css" >
+		g.a { fill: inherit; stroke: green; }
+		.b { stroke: inherit; opacity: inherit; }
+		rect.c { fill: #00ff00; stroke-width: inherit; }
+	</style>
+	<g class="a" style="fill: inherit" opacity="inherit">
+		<rect id="r1" class="b c" style="fill: inherit; stroke: inherit"/>
+		<rect id="r2" class="c" fill="inherit" stroke-width="3"/>
+		<g style="stroke: inherit; opacity: inherit" class="b">
+			<rect id="r3" class="c" style="stroke-width: inherit; fill: inherit" opacity="inherit"/>
+			<circle id="c1" class="b" style="stroke: inherit"/>
+		</g>
+	</g>
+	<circle id="c2" class="b" opacity="inherit" stroke-width="inherit"/>
+</svg>
+)qwertyuiop";
+}
+
+namespace{
+class css_collector : public svgdom::const_visitor{
+public:
+	svgdom::style_stack& ss;
+
+	css_collector(svgdom::style_stack& ss) :
+			ss(ss)
+	{}
+
+	void visit(const svgdom::style_element& e)override{
+		this->ss.add_css(e.css);
+	}
+};
+
+class computed_styles_checker : public svgdom::const_visitor{
+	const svgdom::computed_styles& cs;
+	size_t ordinal = 0;
+
+	void check(const svgdom::element& e){
+		tst::check_eq(this->cs.get_ordinal(e), this->ordinal, SL);
+		tst::check(&this->cs.get_element(this->ordinal) == &e, SL);
+
+		for(size_t i = 0; i != size_t(svgdom::style_property::ENUM_SIZE); ++i){
+			auto p = svgdom::style_property(i);
+			auto expected = this->ss.stack.empty() ? nullptr : this->ss.get_style_property(p);
+			tst::check(this->cs.get(this->ordinal, p) == expected, [&](auto&o){
+				o << "property " << svgdom::styleable::property_to_string(p) << " mismatch for element with ordinal " << this->ordinal << ", id = " << e.id;
+			}, SL);
+			tst::check(this->cs.get(e, p) == expected, SL);
+			tst::check(this->cs.get(this->ordinal)[i] == expected, SL);
+		}
+		++this->ordinal;
+	}
+
+	void visit_element(const svgdom::element& e, const svgdom::container* c){
+		auto s = svgdom::cast_to_styleable(&e);
+		if(!s){
+			this->check(e);
+			if(c){
+				this->relay_accept(*c);
+			}
+			return;
+		}
+		svgdom::style_stack::push push(this->ss, *s);
+		this->check(e);
+		if(c){
+			this->relay_accept(*c);
+		}
+	}
+
+public:
+	svgdom::style_stack ss;
+
+	computed_styles_checker(const svgdom::computed_styles& cs) :
+			cs(cs)
+	{}
+
+	size_t get_num_checked()const noexcept{
+		return this->ordinal;
+	}
+
+	void default_visit(const svgdom::element& e)override{
+		this->visit_element(e, nullptr);
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		this->visit_element(e, &c);
+	}
+};
+
+void check_computed_styles(const svgdom::element& root){
+	svgdom::computed_styles cs(root);
+
+	computed_styles_checker checker(cs);
+	css_collector collector(checker.ss);
+	root.accept(collector);
+
+	root.accept(checker);
+
+	tst::check_eq(checker.get_num_checked(), cs.size(), SL);
+}
+}
+
 namespace{
 tst::set set("style_stack", [](auto& suite){
 	suite.add("basic_test", [](){
@@ -96,5 +209,116 @@ tst::set set("style_stack", [](auto& suite){
 
 		dom->accept(v);
 	});
+
+	suite.add("computed_styles_inherit", [](){
+		auto dom = svgdom::load(papki::span_file(utki::make_span(inherit_svg)));
+		ASSERT_ALWAYS(dom)
+
+		check_computed_styles(*dom);
+
+		svgdom::computed_styles cs(*dom);
+
+		tst::check_eq(cs.size(), size_t(9), SL);
+
+		svgdom::finder_by_id finder(*dom);
+
+		// style 'fill: inherit' on r1 and its parent, the root has no 'fill' style, so,
+		// like in style_stack, CSS value matched for r1 is taken at the root level
+		auto r1 = finder.find("r1");
+		ASSERT_ALWAYS(r1)
+		auto fill = cs.get(*r1, svgdom::style_property::fill);
+		ASSERT_ALWAYS(fill)
+		auto lime = svgdom::parse_paint("#00ff00");
+		ASSERT_ALWAYS(std::get_if<uint32_t>(fill))
+		tst::check_eq(*std::get_if<uint32_t>(fill), *std::get_if<uint32_t>(&lime), SL);
+
+		// CSS rule takes precedence over the presentation attribute
+		auto r2 = finder.find("r2");
+		ASSERT_ALWAYS(r2)
+		fill = cs.get(*r2, svgdom::style_property::fill);
+		ASSERT_ALWAYS(fill)
+		ASSERT_ALWAYS(std::get_if<uint32_t>(fill))
+		tst::check_eq(*std::get_if<uint32_t>(fill), *std::get_if<uint32_t>(&lime), SL);
+
+		// non-inherited property not set anywhere
+		tst::check(!cs.get(*r1, svgdom::style_property::stop_color), SL);
+	});
+
+	suite.add("css_cache_invalidation", [](){
+		auto dom = svgdom::load(papki::span_file(utki::make_span(inherit_svg)));
+		ASSERT_ALWAYS(dom)
+
+		svgdom::finder_by_id finder(*dom);
+		auto r1 = svgdom::cast_to_styleable(finder.find("r1"));
+		ASSERT_ALWAYS(r1)
+		auto c2 = svgdom::cast_to_styleable(finder.find("c2"));
+		ASSERT_ALWAYS(c2)
+
+		const svgdom::style_element* style = nullptr;
+		for(auto& c : dom->children){
+			if(auto se = dynamic_cast<const svgdom::style_element*>(c.get())){
+				style = se;
+			}
+		}
+		ASSERT_ALWAYS(style)
+
+		svgdom::style_stack ss;
+		svgdom::style_stack::push root_push(ss, *dom);
+		{
+			svgdom::style_stack::push push(ss, *r1);
+			tst::check(!ss.get_css_style_property(svgdom::style_property::fill), SL);
+
+			ss.add_css(style->css);
+			auto fill = ss.get_css_style_property(svgdom::style_property::fill);
+			tst::check(fill, SL);
+			tst::check(ss.get_css_style_property(svgdom::style_property::fill) == fill, SL);
+		}
+
+		tst::check(!ss.get_css_style_property(svgdom::style_property::fill), SL);
+		tst::check(!ss.get_css_style_property(svgdom::style_property::opacity), SL);
+
+		{
+			svgdom::style_stack::push push(ss, *c2);
+			tst::check(ss.get_css_style_property(svgdom::style_property::opacity), SL);
+			tst::check(!ss.get_css_style_property(svgdom::style_property::fill), SL);
+		}
+
+		// pushing the element again after the values were memoized for its parent gives up to date values
+		{
+			svgdom::style_stack::push push(ss, *r1);
+			tst::check(ss.get_css_style_property(svgdom::style_property::fill), SL);
+		}
+		tst::check(!ss.get_css_style_property(svgdom::style_property::fill), SL);
+
+		// stack filled directly before the first query matches the same way as the pushed one
+		svgdom::style_stack filled;
+		filled.stack.push_back(*dom);
+		filled.stack.push_back(*r1);
+		filled.add_css(style->css);
+		tst::check(filled.get_css_style_property(svgdom::style_property::fill), SL);
+		tst::check(!filled.get_css_style_property(svgdom::style_property::stop_color), SL);
+	});
+
+	suite.add("computed_styles_same_as_style_stack", [](){
+		for(auto str : {svg, inherit_svg}){
+			auto dom = svgdom::load(papki::span_file(utki::make_span(str)));
+			ASSERT_ALWAYS(dom)
+			check_computed_styles(*dom);
+		}
+
+		const std::string data_dir = "samples_data/";
+		auto files = utki::linq(papki::fs_file(data_dir).list_dir())
+				.where([](const auto& f){
+					static const std::regex suffix_regex("^.*\\.svg$");
+					return std::regex_match(f, suffix_regex);
+				})
+				.get();
+
+		for(const auto& f : files){
+			auto dom = svgdom::load(papki::fs_file(data_dir + f));
+			ASSERT_ALWAYS(dom)
+			check_computed_styles(*dom);
+		}
+	});
 });
 }
\ No newline at end of file
@@ -3,9 +3,11 @@
 
 #include <utki/time.hpp>
 #include <papki/fs_file.hpp>
+#include <papki/span_file.hpp>
 
 #include "../../src/svgdom/dom.hpp"
 #include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/elements/style.hpp"
 #include "../../src/svgdom/util/style_stack_cache.hpp"
 
 namespace{
@@ -46,5 +48,82 @@ tst::set set("style_stack_cache", [](auto& suite){
 				tst::check(visitor.style_stack_cache.size() == 17763, [&](auto&o){o << "visitor.style_stack_cache.size() = " << visitor.style_stack_cache.size();}, SL);
 			}
 		);
+
+	suite.add(
+			"deep_nesting",
+			[](){
+				const unsigned depth = 1000;
+				const unsigned num_leaves = 50;
+
+				std::string str = R"(<svg xmlns="http://www.w3.org/2000/svg" id="root">)";
+				for(unsigned i = 0; i != depth; ++i){
+					str += "<g id=\"g" + std::to_string(i) + "\">";
+					for(unsigned j = 0; j != num_leaves; ++j){
+						str += "<rect id=\"r" + std::to_string(i) + "_" + std::to_string(j) + "\"/>";
+					}
+				}
+				for(unsigned i = 0; i != depth; ++i){
+					str += "</g>";
+				}
+				str += "</svg>";
+
+				auto dom = svgdom::load(papki::span_file(utki::make_span(str)));
+				tst::check(dom != nullptr, SL);
+
+				svgdom::style_stack_cache cache(*dom);
+
+				tst::check_eq(cache.size(), size_t(1 + depth * (num_leaves + 1)), SL);
+
+				auto root = cache.find_node("root");
+				tst::check(root != nullptr, SL);
+				tst::check_eq(root->depth, size_t(1), SL);
+				tst::check(root->parent == nullptr, SL);
+				tst::check(&root->value == dom.get(), SL);
+
+				auto g = cache.find_node("g" + std::to_string(depth - 1));
+				tst::check(g != nullptr, SL);
+				tst::check_eq(g->depth, size_t(depth + 1), SL);
+
+				auto r = cache.find_node("r" + std::to_string(depth - 1) + "_0");
+				tst::check(r != nullptr, SL);
+				tst::check_eq(r->depth, size_t(depth + 2), SL);
+				tst::check(r->parent == g, SL);
+
+				auto ss = r->make_style_stack();
+				tst::check_eq(ss.stack.size(), r->depth, SL);
+				tst::check(&ss.stack.front().get() == dom.get(), SL);
+				tst::check(&ss.stack.back().get() == &r->value, SL);
+				tst::check(&ss.stack[depth].get() == &g->value, SL);
+
+				// find() gives the same style stack, made once
+				auto found = cache.find("r" + std::to_string(depth - 1) + "_0");
+				tst::check(found != nullptr, SL);
+				tst::check_eq(found->stack.size(), ss.stack.size(), SL);
+				tst::check(&found->stack.back().get() == &r->value, SL);
+				tst::check(cache.find("r" + std::to_string(depth - 1) + "_0") == found, SL);
+
+				tst::check(cache.find("nonexistent") == nullptr, SL);
+				tst::check(cache.find("") == nullptr, SL);
+				tst::check(cache.find_node("nonexistent") == nullptr, SL);
+			}
+		);
+
+	suite.add(
+			"empty_style_stack",
+			[](){
+				// element which is not styleable and has no styleable ancestors
+				svgdom::style_element e;
+				e.id = "style";
+
+				svgdom::style_stack_cache cache(e);
+				tst::check_eq(cache.size(), size_t(1), SL);
+
+				tst::check(cache.find_node("style") == nullptr, SL);
+
+				auto ss = cache.find("style");
+				tst::check(ss != nullptr, SL);
+				tst::check(ss->stack.empty(), SL);
+			}
+		);
 });
 }
@@ -3,6 +3,11 @@
 
 #include "../../src/svgdom/elements/structurals.hpp"
 #include "../../src/svgdom/elements/shapes.hpp"
+#include "../../src/svgdom/util/stream_writer.hpp"
+
+#include <sstream>
+#include <limits>
+#include <stdexcept>
 
 tst::set to_string_tests("to_string", [](auto& suite){
 	suite.add(
@@ -48,4 +53,204 @@ tst::set to_string_tests("to_string", [](auto& suite){
 			}
 		);
 
+
+	suite.add(
+			"numbers_are_formatted_as_by_ostream",
+			[](){
+				std::vector<svgdom::real> values = {
+					0, -0.0f, 1, -1, 0.1f, 0.5f, 1.5f, 100, 123456, 1234567, 999999.5f, 1e-5f, 1.2345e-5f, 0.0001f,
+					1e20f, -3.40282e38f, 123.456789f, 1.0f / 3, 2.0f / 3, 65.4321f, 99.99995f, 0.000123456789f,
+					std::numeric_limits<svgdom::real>::min(),
+					std::numeric_limits<svgdom::real>::max(),
+					std::numeric_limits<svgdom::real>::denorm_min()
+				};
+
+				for(auto v : values){
+					svgdom::polyline_element e;
+					e.points.push_back({v, -v});
+
+					std::stringstream ss;
+					ss << v << "," << -v;
+
+					tst::check_eq(e.points_to_string(), ss.str(), SL);
+
+					if(v == 0){
+						// zero length is equal to default width of the rect, so it is not written
+						continue;
+					}
+
+					svgdom::rect_element r;
+					r.width = svgdom::length(v, svgdom::length_unit::mm);
+
+					std::stringstream ls;
+					ls << "width=\"" << v << "mm\"";
+
+					tst::check(r.to_string().find(ls.str()) != std::string::npos, SL) << r.to_string();
+				}
+			}
+		);
+
+	suite.add(
+			"path_is_converted_to_compact_string",
+			[](){
+				std::vector<std::pair<std::string, std::string>> samples = {
+					{"M 10,20 L 30,40 L 50,60", "M10 20 30 40 50 60"},
+					{"M 0.5,0.5 L -0.5,-0.5", "M.5.5l-1-1"},
+					{"M 100 100 L 200 100 L 200 200 Z", "M100 100l100 0 0 100z"},
+					{"M 10 10 A 5 5 0 0 1 20 10", "M10 10a5 5 0 0 1 10 0"},
+					{"M 0.00001 0 h 1.5 v -0.25", "M1e-5 0h1.5V-.25"},
+					{"M 10 10 z m 1 1 z", "M10 10zm1 1z"}
+				};
+
+				for(auto& s : samples){
+					svgdom::path_element e;
+					e.path = svgdom::path_element::parse(s.first);
+
+					tst::check_eq(e.path_to_compact_string(), s.second, SL);
+
+					// the output is valid path data
+					tst::check_eq(svgdom::path_element::parse(s.second).size(), e.path.size(), SL);
+				}
+			}
+		);
+
+	suite.add(
+			"compact_path_rounding_errors_do_not_accumulate",
+			[](){
+				const unsigned num_steps = 1000;
+				const svgdom::real step = 0.1234567f;
+				const svgdom::real back_step = 0.1225432f;
+
+				// zigzag path, rounding errors of the relative steps would have the same sign
+				svgdom::path_element e;
+				e.path = svgdom::path_element::parse("M 0 0");
+				for(unsigned i = 0; i != num_steps; ++i){
+					auto s = svgdom::path_element::parse("l 0 0").front();
+					s.x = i % 2 == 0 ? step : -back_step;
+					e.path.push_back(s);
+				}
+
+				// relative coordinates are resolved the same way as the path data consumers do it
+				auto end_point = [](const std::vector<svgdom::path_element::step>& path){
+					svgdom::real x = 0;
+					svgdom::real y = 0;
+					for(auto& s : path){
+						if(s.type_ == svgdom::path_element::step::type::line_rel || s.type_ == svgdom::path_element::step::type::move_rel){
+							x += s.x;
+							y += s.y;
+						}else{
+							x = s.x;
+							y = s.y;
+						}
+					}
+					return std::make_pair(x, y);
+				};
+
+				auto expected = end_point(e.path);
+				auto actual = end_point(svgdom::path_element::parse(e.path_to_compact_string(3)));
+
+				// writing each step with 3 significant digits independently would give an error of about 0.46
+				using std::abs;
+				tst::check(abs(actual.first - expected.first) < 0.001f, SL) << "actual = " << actual.first << ", expected = " << expected.first;
+				tst::check_eq(actual.second, expected.second, SL);
+			}
+		);
+
+	suite.add(
+			"compact_output_has_no_whitespace_and_redundant_attributes",
+			[](){
+				auto dom = std::make_unique<svgdom::svg_element>();
+
+				auto g = std::make_unique<svgdom::g_element>();
+				g->presentation_attributes[svgdom::style_property::opacity] = svgdom::real(1);
+				g->presentation_attributes[svgdom::style_property::fill_opacity] = svgdom::real(1);
+				g->presentation_attributes[svgdom::style_property::stroke_width] = svgdom::length(1.23456789f);
+				g->styles[svgdom::style_property::stroke_width] = svgdom::length(2);
+
+				auto rect = std::make_unique<svgdom::rect_element>();
+				rect->x = svgdom::length(0.123456789f);
+				g->children.push_back(std::move(rect));
+
+				dom->children.push_back(std::move(g));
+
+				svgdom::write_options options;
+				options.compact = true;
+				options.precision = 3;
+
+				auto str = dom->to_string(options);
+
+				tst::check(str.find_first_of("\n\t") == std::string::npos, SL) << str;
+				tst::check(str.find("><g") != std::string::npos, SL) << str;
+
+				// non-inherited property with initial value is omitted
+				tst::check(str.find(" opacity=") == std::string::npos, SL) << str;
+
+				// inherited property is kept even if it has initial value
+				tst::check(str.find("fill-opacity=\"1\"") != std::string::npos, SL) << str;
+
+				// presentation attribute overridden by inline style is omitted
+				tst::check(str.find("stroke-width=") == std::string::npos, SL) << str;
+				tst::check(str.find("style=\"stroke-width:2\"") != std::string::npos, SL) << str;
+
+				tst::check(str.find("x=\"0.123\"") != std::string::npos, SL) << str;
+
+				// default options give the same output as before
+				tst::check_eq(dom->to_string(svgdom::write_options()), dom->to_string(), SL);
+			}
+		);
+
+	suite.add(
+			"zero_precision_is_rejected",
+			[](){
+				auto dom = std::make_unique<svgdom::svg_element>();
+
+				auto path = std::make_unique<svgdom::path_element>();
+				path->path = svgdom::path_element::parse("M1.5 2 l3 4");
+				auto& p = *path;
+				dom->children.push_back(std::move(path));
+
+				svgdom::write_options options;
+				options.compact = true;
+				options.precision = 0;
+
+				bool thrown = false;
+				try{
+					dom->to_string(options);
+				}catch(std::invalid_argument&){
+					thrown = true;
+				}
+				tst::check(thrown, SL);
+
+				// path data alone is written with at least one significant digit
+				tst::check_eq(p.path_to_compact_string(0), p.path_to_compact_string(1), SL);
+			}
+		);
+
+	suite.add(
+			"stream_is_flushed_once_after_outermost_element",
+			[](){
+				class sync_counting_buf : public std::stringbuf{
+				public:
+					unsigned num_syncs = 0;
+				protected:
+					int sync()override{
+						++this->num_syncs;
+						return this->std::stringbuf::sync();
+					}
+				} buf;
+				std::ostream s(&buf);
+
+				auto dom = std::make_unique<svgdom::svg_element>();
+				auto g = std::make_unique<svgdom::g_element>();
+				g->children.push_back(std::make_unique<svgdom::rect_element>());
+				g->children.push_back(std::make_unique<svgdom::circle_element>());
+				dom->children.push_back(std::move(g));
+
+				svgdom::stream_writer w(s);
+				dom->accept(w);
+
+				tst::check_eq(buf.num_syncs, 1u, SL);
+				tst::check_eq(buf.str(), dom->to_string(), SL);
+			}
+		);
 });
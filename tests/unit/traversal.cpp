@@ -0,0 +1,268 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <cstring>
+#include <atomic>
+
+#include <papki/span_file.hpp>
+
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/elements/shapes.hpp"
+#include "../../src/svgdom/util/traversal.hpp"
+#include "../../src/svgdom/util/finder_by_id.hpp"
+#include "../../src/svgdom/util/finder_by_class.hpp"
+#include "../../src/svgdom/util/parallel_traversal.hpp"
+
+namespace{
+const char* svg = R"(
+	<svg xmlns="http://www.w3.org/2000/svg" id="a">
+		<g id="b">
+			<rect id="c"/>
+			<g id="d">
+				<circle id="e"/>
+			</g>
+		</g>
+		<defs id="f"/>
+		<path id="g"/>
+	</svg>
+)";
+}
+
+namespace{
+// builds a tree of groups with different nesting and width
+std::unique_ptr<svgdom::svg_element> make_test_tree(){
+	auto dom = std::make_unique<svgdom::svg_element>();
+	dom->id = "root";
+	for(unsigned i = 0; i != 7; ++i){
+		auto g = std::make_unique<svgdom::g_element>();
+		g->id = "g" + std::to_string(i);
+		g->classes.push_back("c" + std::to_string(i % 3));
+		svgdom::container* c = g.get();
+		for(unsigned j = 0; j != i * 3; ++j){
+			auto r = std::make_unique<svgdom::rect_element>();
+			r->id = "r" + std::to_string(i) + "_" + std::to_string(j);
+			r->classes.push_back("c" + std::to_string(j % 3));
+			c->children.push_back(std::move(r));
+			if(j % 4 == 0){
+				auto sub = std::make_unique<svgdom::g_element>();
+				sub->id = "g" + std::to_string(i) + "_" + std::to_string(j);
+				auto next = sub.get();
+				c->children.push_back(std::move(sub));
+				c = next;
+			}
+		}
+		dom->children.push_back(std::move(g));
+	}
+	return dom;
+}
+
+class element_list_collector{
+public:
+	std::vector<const svgdom::element*> elements;
+
+	void operator()(const svgdom::element& e){
+		this->elements.push_back(&e);
+	}
+};
+}
+
+namespace{
+tst::set set("traversal", [](auto& suite){
+	suite.add("pre_order", [](){
+		auto dom = svgdom::load(papki::span_file(utki::make_span(svg, strlen(svg))));
+		tst::check(dom, SL);
+
+		std::string ids;
+		svgdom::traversal::pre_order(*dom, [&ids](const svgdom::element& e){
+			ids += e.id;
+		});
+		tst::check_eq(ids, std::string("abcdefg"), SL);
+	});
+
+	suite.add("post_order", [](){
+		auto dom = svgdom::load(papki::span_file(utki::make_span(svg, strlen(svg))));
+		tst::check(dom, SL);
+
+		std::string ids;
+		svgdom::traversal::post_order(*dom, [&ids](const svgdom::element& e){
+			ids += e.id;
+		});
+		tst::check_eq(ids, std::string("cedbfga"), SL);
+	});
+
+	suite.add("filtered_pre_order", [](){
+		auto dom = svgdom::load(papki::span_file(utki::make_span(svg, strlen(svg))));
+		tst::check(dom, SL);
+
+		// skip children of 'd' element
+		std::string ids;
+		svgdom::traversal::pre_order(*dom, [&ids](const svgdom::element& e){
+			ids += e.id;
+			return e.id != "d";
+		});
+		tst::check_eq(ids, std::string("abcdfg"), SL);
+
+		// skip all children of the root element
+		ids.clear();
+		svgdom::traversal::pre_order(*dom, [&ids](const svgdom::element& e){
+			ids += e.id;
+			return false;
+		});
+		tst::check_eq(ids, std::string("a"), SL);
+	});
+
+	suite.add("leaf_root", [](){
+		svgdom::rect_element r;
+		r.id = "r";
+
+		std::string pre;
+		svgdom::traversal::pre_order(r, [&pre](const svgdom::element& e){
+			pre += e.id;
+		});
+		tst::check_eq(pre, std::string("r"), SL);
+
+		std::string post;
+		svgdom::traversal::post_order(r, [&post](const svgdom::element& e){
+			post += e.id;
+		});
+		tst::check_eq(post, std::string("r"), SL);
+	});
+
+	suite.add("parallel_pre_order", [](){
+		for(unsigned num_threads : {1, 2, 3, 8, 0}){
+			auto dom = make_test_tree();
+
+			element_list_collector expected;
+			svgdom::traversal::pre_order(*dom, expected);
+
+			size_t num_workers = 0;
+			std::vector<const svgdom::element*> elements;
+			svgdom::parallel_traversal::pre_order(
+					*dom,
+					[](){return element_list_collector();},
+					[&](element_list_collector& c){
+						++num_workers;
+						elements.insert(elements.end(), c.elements.begin(), c.elements.end());
+					},
+					num_threads
+				);
+
+			tst::check(num_workers != 0, SL) << "num_threads = " << num_threads;
+			tst::check(elements == expected.elements, SL) << "num_threads = " << num_threads;
+
+			svgdom::finder_by_id expected_by_id(*dom);
+			svgdom::finder_by_id by_id(*dom, num_threads);
+			tst::check_eq(by_id.size(), expected_by_id.size(), SL);
+			for(auto e : expected.elements){
+				tst::check(by_id.find(e->id) == expected_by_id.find(e->id), SL) << "id = " << e->id;
+			}
+
+			svgdom::finder_by_class expected_by_class(*dom);
+			svgdom::finder_by_class by_class(*dom, num_threads);
+			tst::check_eq(by_class.size(), expected_by_class.size(), SL);
+			for(auto c : {"c0", "c1", "c2"}){
+				auto found = by_class.find(c);
+				auto expected_found = expected_by_class.find(c);
+				tst::check(!found.empty(), SL);
+				tst::check(std::equal(found.begin(), found.end(), expected_found.begin(), expected_found.end()), SL);
+			}
+		}
+	});
+
+	suite.add("parallel_pre_order_rethrows", [](){
+		auto dom = make_test_tree();
+
+		bool thrown = false;
+		try{
+			svgdom::parallel_traversal::pre_order(
+					*dom,
+					[](){
+						return [](const svgdom::element& e){
+							if(e.id == "r6_5"){
+								throw std::runtime_error("test");
+							}
+						};
+					},
+					[](auto&){},
+					4
+				);
+		}catch(std::runtime_error& e){
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+	});
+
+	suite.add("parallel_partition", [](){
+		for(unsigned num_threads : {1, 2, 3, 8, 0}){
+			auto dom = make_test_tree();
+
+			element_list_collector expected;
+			svgdom::traversal::pre_order(*dom, expected);
+
+			auto p = svgdom::parallel_traversal::make_partition(*dom, num_threads);
+			tst::check(p.num_threads != 0, SL) << "num_threads = " << num_threads;
+			tst::check(!p.tasks.empty(), SL) << "num_threads = " << num_threads;
+
+			// tasks are consecutive ranges of the items
+			const svgdom::parallel_traversal::item* next = p.items.data();
+			for(const auto& t : p.tasks){
+				tst::check(t.data() == next, SL) << "num_threads = " << num_threads;
+				next = t.data() + t.size();
+			}
+			tst::check(next == p.items.data() + p.items.size(), SL) << "num_threads = " << num_threads;
+
+			// each element is covered by exactly one item, in pre-order
+			element_list_collector covered;
+			for(const auto& i : p.items){
+				if(i.deep){
+					svgdom::traversal::pre_order(*i.e, covered);
+				}else{
+					covered(*i.e);
+				}
+			}
+			tst::check(covered.elements == expected.elements, SL) << "num_threads = " << num_threads;
+
+			// each task is run exactly once
+			std::vector<std::atomic<unsigned>> num_runs(p.tasks.size());
+			svgdom::parallel_traversal::run(p, [&](size_t i){
+				++num_runs[i];
+			});
+			for(const auto& n : num_runs){
+				tst::check_eq(n.load(), 1u, SL) << "num_threads = " << num_threads;
+			}
+		}
+	});
+
+	suite.add("deep_nesting", [](){
+		const unsigned depth = 10000;
+
+		auto dom = std::make_unique<svgdom::svg_element>();
+		svgdom::container* c = dom.get();
+		for(unsigned i = 0; i != depth; ++i){
+			auto g = std::make_unique<svgdom::g_element>();
+			g->id = std::to_string(i);
+			auto next = g.get();
+			c->children.push_back(std::move(g));
+			c = next;
+		}
+
+		size_t num_pre = 0;
+		svgdom::traversal::pre_order(*dom, [&num_pre](const svgdom::element& e){
+			++num_pre;
+		});
+		tst::check_eq(num_pre, size_t(depth + 1), SL);
+
+		std::vector<const svgdom::element*> post;
+		svgdom::traversal::post_order(*dom, [&post](const svgdom::element& e){
+			post.push_back(&e);
+		});
+		tst::check_eq(post.size(), size_t(depth + 1), SL);
+		tst::check_eq(post.front()->id, std::to_string(depth - 1), SL);
+		tst::check(post.back() == dom.get(), SL);
+
+		svgdom::finder_by_id finder(*dom);
+		tst::check_eq(finder.size(), size_t(depth), SL);
+		tst::check(finder.find(std::to_string(depth - 1)) == post.front(), SL);
+	});
+});
+}